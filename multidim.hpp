@@ -40,6 +40,35 @@
 #include <type_traits> // is_lvalue_reference, enable_if etc.
 #include <limits> // std::numeric_limits
 #include <algorithm> // std::copy_n
+#include <tuple> // ZipView
+#include <stdexcept> // std::runtime_error
+#include <functional> // Executor
+#include <memory> // std::unique_ptr, std::shared_ptr
+#include <deque> // ThreadPoolExecutor
+#include <thread> // ThreadPoolExecutor
+#include <mutex> // ThreadPoolExecutor
+#include <condition_variable> // ThreadPoolExecutor
+#include <atomic> // ThreadPoolExecutor
+#include <exception> // std::exception_ptr
+#include <map> // BoundsStatistics
+#include <cstdint> // uint64_t
+#include <array> // makeReshapedView
+#include <numeric> // std::partial_sum
+#include <new> // placement new (SmallVector)
+#include <initializer_list> // SmallVector
+#include <cmath> // std::nearbyint
+
+#ifdef _OPENMP
+#include <omp.h> // OpenMPExecutor
+#endif
+
+#ifdef __BMI2__
+#include <immintrin.h> // _pdep_u64, _pext_u64
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h> // ConvertKernel
+#endif
 
 // Since this is intended as a general-purpose module,
 // I prefer not to #include any Boost library
@@ -66,6 +95,59 @@ namespace multidim {
  * of user-defined bounds, cropping and filling as needed.
  */
 
+/** \defgroup zip_view ZipView
+ * \brief A class which iterates several equally-shaped multilevel ranges
+ * in lockstep
+ */
+
+/** \defgroup indirect_view IndirectView
+ * \brief Views whose outermost dimension is reordered or subset
+ * through an array of indices
+ */
+
+/** \defgroup flat_view_adaptors FlatView adaptors
+ * \brief Views which filter or transform lazily the scalars of a FlatView
+ */
+
+/** \defgroup reshaped_view ReshapedView
+ * \brief Views which make a flat buffer appear as a nested container
+ */
+
+/** \defgroup morton Morton order
+ * \brief Traversal and storage of boxed data in Z-order (Morton order),
+ * which keeps neighbouring cells close in memory
+ */
+
+/** \defgroup keyed_view KeyedView
+ * \brief Square-bracket access to nested associative containers
+ * (`std::map`, `std::unordered_map`...) through key lookups
+ */
+
+/** \defgroup sparse_array SparseArray
+ * \brief Hash-based storage of sparse D-dimensional arrays
+ */
+
+/** \defgroup cow_container CowContainer
+ * \brief Nested containers with copy-on-write rows and cheap snapshots
+ */
+
+/** \defgroup concurrent_jagged ConcurrentJagged
+ * \brief Append-only jagged container for concurrent producers
+ */
+
+/** \defgroup small_vector SmallVector
+ * \brief Rows storing their first elements inline, for jagged containers
+ * of mostly short rows
+ */
+
+/** \defgroup segmented_vector SegmentedVector
+ * \brief Vector made of fixed-size chunks, flat-iterable under appends
+ */
+
+/** \defgroup executors Executors
+ * \brief Execution backends of the parallel algorithms
+ */
+
 /** \defgroup detail Implementation details
  * \brief Low-level machinery extending the `<type_traits>` library.
  * Should not be used by client code
@@ -112,6 +194,34 @@ struct Forward {};
  */
 struct Backward {};
 
+// **************************************************************************
+// IndexSequence
+// **************************************************************************
+/** \brief Compile-time list of indices, used to unpack tuples
+ * (C++11 lacks `std::index_sequence`)
+ * \ingroup detail
+ */
+template <size_t... indices>
+struct IndexSequence {};
+
+/** \brief Provides the member typedef `type` as `IndexSequence<0, ..., N-1>`
+ * \ingroup detail
+ * \param N (size_t)
+ */
+template <size_t N, size_t... indices>
+struct MakeIndexSequence : MakeIndexSequence<N-1, N-1, indices...> {};
+
+template <size_t... indices>
+struct MakeIndexSequence<0, indices...> {
+    using type = IndexSequence<indices...>;
+};
+
+/** \brief Helper to evaluate an expression on every element of a pack,
+ * e.g. `(void)Swallow{0, (++std::get<indices>(tuple), 0)...};`
+ * \ingroup detail
+ */
+using Swallow = int[];
+
 //***************************************************************************
 // IsRange
 //***************************************************************************
@@ -399,7 +509,7 @@ template <
     >::type = 0xBEEF
 >
 std::vector<size_t> bounds(Iterator const& first, Iterator const& last, size_t precomputedDistance = NO_VALUE) {
-    constexpr auto rangeDimensionality = dimensionality<ScalarPolicy>(first, last);
+    constexpr auto rangeDimensionality = DimensionalityRange<ScalarPolicy, Iterator>::value;
 
     std::vector<size_t> containerBounds(rangeDimensionality);
 
@@ -572,6 +682,622 @@ constexpr auto scalarType(Iterator first, Iterator last)
 
 } // namespace multidim - Basics
 
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @Executor
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// Executor
+//***************************************************************************
+/** \brief Interface of the execution backends used by the parallel
+ * algorithms of the library. An implementation must run
+ * `task(0)`, ..., `task(taskCount-1)`, possibly concurrently,
+ * and return only when all of them have completed.
+ * If a task throws, the exception must be propagated to the caller
+ * (if more tasks throw, only one exception is propagated).
+ * \ingroup executors
+ */
+class Executor {
+public:
+    virtual ~Executor() {}
+
+    /** \brief Number of tasks which the executor can run concurrently */
+    virtual size_t concurrency() const = 0;
+
+    virtual void bulkExecute(
+        size_t taskCount, const std::function<void(size_t)>& task
+    ) = 0;
+};
+
+//***************************************************************************
+// SerialExecutor
+//***************************************************************************
+/** \brief Executor running all the tasks in the calling thread
+ * \ingroup executors
+ */
+class SerialExecutor : public Executor {
+public:
+    size_t concurrency() const override {return 1;}
+
+    void bulkExecute(
+        size_t taskCount, const std::function<void(size_t)>& task
+    ) override {
+        for (size_t i = 0; i < taskCount; ++i) task(i);
+    }
+};
+
+//***************************************************************************
+// ThreadPoolExecutor
+//***************************************************************************
+/** \brief Executor backed by a pool of threads which steal work
+ * from each other. Each worker has its own queue, from which it pops the
+ * most recent task, and steals the oldest tasks from the other queues
+ * when it runs out of work. The thread calling `bulkExecute` takes part
+ * in the work too, so nested calls cannot deadlock.
+ * \ingroup executors
+ */
+class ThreadPoolExecutor : public Executor {
+public:
+    /** \param workerCount number of threads to be started, besides the
+     *  ones which will call `bulkExecute` */
+    explicit ThreadPoolExecutor(size_t workerCount) {
+        for (size_t i = 0; i < workerCount + 1; ++i) {
+            queues_.emplace_back(new Queue{});
+        }
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers_.emplace_back([this, i]{workerLoop(i);});
+        }
+    }
+    ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+    ~ThreadPoolExecutor() {
+        {
+            std::lock_guard<std::mutex> lock{sleepMutex_};
+            stop_ = true;
+        }
+        wakeUp_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    size_t concurrency() const override {return workers_.size() + 1;}
+
+    void bulkExecute(
+        size_t taskCount, const std::function<void(size_t)>& task
+    ) override {
+        if (taskCount == 0) return;
+        if (taskCount == 1 || workers_.empty()) {
+            for (size_t i = 0; i < taskCount; ++i) task(i);
+            return;
+        }
+
+        Batch batch{taskCount};
+        for (size_t i = 0; i < taskCount; ++i) {
+            // Round robin over the queues of the workers,
+            // the last queue is shared by the external callers
+            push(i % queues_.size(), [&batch, &task, i]{batch.run(task, i);});
+        }
+
+        // Help the workers till the batch is over
+        while (batch.remaining.load() > 0) {
+            if (runOne(queues_.size() - 1)) continue;
+            std::unique_lock<std::mutex> lock{batch.mutex};
+            batch.done.wait(lock, [&batch]{return batch.remaining.load() == 0;});
+        }
+
+        std::lock_guard<std::mutex> lock{batch.mutex};
+        if (batch.error) std::rethrow_exception(batch.error);
+    }
+
+private: // types
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    struct Batch {
+        explicit Batch(size_t taskCount) : remaining{taskCount} {}
+
+        void run(const std::function<void(size_t)>& task, size_t index) {
+            try {
+                task(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (!error) error = std::current_exception();
+            }
+            // The counter is decremented under the lock, otherwise
+            // bulkExecute could return (destroying the batch)
+            // between the decrement and the notification
+            std::lock_guard<std::mutex> lock{mutex};
+            if (--remaining == 0) done.notify_all();
+        }
+
+        std::atomic<size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+private: // funcs
+    void push(size_t queueIndex, std::function<void()> job) {
+        // pending_ is increased first, so that it cannot underflow
+        // if the job is popped immediately
+        {
+            std::lock_guard<std::mutex> lock{sleepMutex_};
+            ++pending_;
+        }
+        {
+            std::lock_guard<std::mutex> lock{queues_[queueIndex]->mutex};
+            queues_[queueIndex]->tasks.push_back(std::move(job));
+        }
+        wakeUp_.notify_one();
+    }
+
+    // Pops a task from the queue `queueIndex` (newest first), or steals
+    // one from the other queues (oldest first), and runs it.
+    // Returns false if no task was found
+    bool runOne(size_t queueIndex) {
+        std::function<void()> job;
+        for (size_t offset = 0; offset < queues_.size() && !job; ++offset) {
+            auto& queue = *queues_[(queueIndex + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock{queue.mutex};
+            if (queue.tasks.empty()) continue;
+            if (offset == 0) {
+                job = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                job = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+        if (!job) return false;
+
+        {
+            std::lock_guard<std::mutex> lock{sleepMutex_};
+            --pending_;
+        }
+        job();
+        return true;
+    }
+
+    void workerLoop(size_t index) {
+        while (1) {
+            if (runOne(index)) continue;
+            std::unique_lock<std::mutex> lock{sleepMutex_};
+            wakeUp_.wait(lock, [this]{return stop_ || pending_ > 0;});
+            if (stop_) return;
+        }
+    }
+
+private: // members
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex sleepMutex_;
+    std::condition_variable wakeUp_;
+    size_t pending_ = 0;
+    bool stop_ = false;
+};
+
+//***************************************************************************
+// FunctionExecutor
+//***************************************************************************
+/** \brief Adapter to run the parallel algorithms on an executor
+ * of the client code (e.g. an existing thread pool).
+ * The adapted executor is represented by a function which schedules
+ * a job for asynchronous execution. The jobs pull the tasks from a shared
+ * counter, and the thread calling `bulkExecute` does the same, so the
+ * tasks are completed even if the adapted executor is busy.
+ * \ingroup executors
+ */
+class FunctionExecutor : public Executor {
+public:
+    using SubmitFunction = std::function<void(std::function<void()>)>;
+
+    /** \param submit function scheduling a job on the adapted executor
+     * \param concurrency number of jobs the adapted executor can run
+     *  concurrently */
+    FunctionExecutor(SubmitFunction submit, size_t concurrency) :
+        submit_{std::move(submit)},
+        concurrency_{concurrency}
+    {}
+
+    size_t concurrency() const override {return concurrency_ + 1;}
+
+    void bulkExecute(
+        size_t taskCount, const std::function<void(size_t)>& task
+    ) override {
+        if (taskCount == 0) return;
+
+        // The state is shared with the submitted jobs, which may start
+        // even after this function has returned
+        auto state = std::make_shared<State>(task, taskCount);
+        const size_t jobCount = std::min(concurrency_, taskCount - 1);
+        std::exception_ptr submitError;
+        try {
+            for (size_t i = 0; i < jobCount; ++i) {
+                submit_([state]{state->work();});
+            }
+        } catch (...) {
+            // the jobs already submitted still refer to task:
+            // complete all the tasks before leaving
+            submitError = std::current_exception();
+        }
+
+        state->work();
+
+        std::unique_lock<std::mutex> lock{state->mutex};
+        state->done.wait(lock, [&state]{return state->tasksDone == state->taskCount;});
+        if (submitError) std::rethrow_exception(submitError);
+        if (state->error) std::rethrow_exception(state->error);
+    }
+
+private: // types
+    struct State {
+        State(const std::function<void(size_t)>& task, size_t taskCount) :
+            task{task}, taskCount{taskCount} {}
+
+        void work() {
+            while (1) {
+                const size_t index = nextTask++;
+                if (index >= taskCount) return;
+                try {
+                    task(index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    if (!error) error = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock{mutex};
+                if (++tasksDone == taskCount) done.notify_all();
+            }
+        }
+
+        const std::function<void(size_t)>& task;
+            // only dereferenced while tasks are pending,
+            // i.e. while bulkExecute is still running
+        const size_t taskCount;
+        std::atomic<size_t> nextTask{0};
+        size_t tasksDone = 0;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+private: // members
+    SubmitFunction submit_;
+    size_t concurrency_;
+};
+
+#ifdef _OPENMP
+//***************************************************************************
+// OpenMPExecutor
+//***************************************************************************
+/** \brief Executor running the tasks on the OpenMP runtime.
+ * If called inside a parallel region, the tasks are run as OpenMP tasks
+ * by the current team, otherwise a new parallel region is opened.
+ * Only available if the code is compiled with OpenMP support.
+ * \ingroup executors
+ */
+class OpenMPExecutor : public Executor {
+public:
+    size_t concurrency() const override {
+        return static_cast<size_t>(
+            omp_in_parallel() ? omp_get_num_threads() : omp_get_max_threads()
+        );
+    }
+
+    void bulkExecute(
+        size_t taskCount, const std::function<void(size_t)>& task
+    ) override {
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        auto guardedTask = [&](size_t index) {
+            // exceptions must not escape an OpenMP construct
+            try {
+                task(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock{errorMutex};
+                if (!error) error = std::current_exception();
+            }
+        };
+
+        if (omp_in_parallel()) {
+            #pragma omp taskgroup
+            {
+                for (size_t i = 0; i < taskCount; ++i) {
+                    #pragma omp task firstprivate(i) shared(guardedTask)
+                    guardedTask(i);
+                }
+            }
+        } else {
+            const long long count = static_cast<long long>(taskCount);
+            #pragma omp parallel for schedule(dynamic)
+            for (long long i = 0; i < count; ++i) {
+                guardedTask(static_cast<size_t>(i));
+            }
+        }
+
+        if (error) std::rethrow_exception(error);
+    }
+};
+#endif // _OPENMP
+
+//***************************************************************************
+// defaultExecutor
+//***************************************************************************
+/** \brief Returns the executor used by the parallel algorithms
+ * if the client code does not indicate one: a ThreadPoolExecutor
+ * which, together with the calling thread, saturates the hardware threads.
+ * The pool is started on first use.
+ * \ingroup executors
+ */
+inline Executor& defaultExecutor() {
+    static ThreadPoolExecutor pool{
+        std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1
+    };
+    return pool;
+}
+
+//***************************************************************************
+// parallelChunks
+//***************************************************************************
+/** \brief Returns the number of chunks in which `workItems` items
+ * should be partitioned to keep all the threads of `executor` busy
+ * \ingroup detail
+ * \param minChunkSize minimum number of items in a chunk, to limit
+ *  the scheduling overhead
+ */
+inline size_t parallelChunkCount(
+    const Executor& executor, size_t workItems, size_t minChunkSize = 1
+) {
+    const size_t wanted = executor.concurrency() * 4;
+        // some slack, to balance uneven chunks
+    const size_t allowed = workItems / std::max<size_t>(minChunkSize, 1);
+    return std::max<size_t>(std::min(wanted, allowed), 1);
+}
+
+/** \brief Partitions [0, workItems) in `chunkCount` contiguous chunks and
+ * calls `function(chunkIndex, chunkBegin, chunkEnd)` for each of them
+ * through `executor`
+ * \ingroup detail
+ */
+template <typename Function>
+void parallelChunks(
+    Executor& executor, size_t workItems, size_t chunkCount,
+    const Function& function
+) {
+    if (chunkCount == 0) return;
+    executor.bulkExecute(chunkCount, [&](size_t chunk) {
+        function(
+            chunk,
+            workItems * chunk / chunkCount,
+            workItems * (chunk + 1) / chunkCount
+        );
+    });
+}
+
+
+//***************************************************************************
+// parallelBounds
+//***************************************************************************
+/** \brief Statistics about the lengths of the subranges found
+ * in one dimension of a nested container, see `parallelBounds`
+ * \ingroup user_functions
+ */
+struct BoundsStatistics {
+    double averageLength = 0;
+        /**< average size of the subranges */
+    size_t p99Length = 0;
+        /**< 99th percentile of the size of the subranges */
+    double paddingRatio = 0;
+        /**< fraction of the elements of this dimension in the bounding box
+         * which are not physically present, i.e. which a BoxedView would
+         * fill with the default value */
+};
+
+/** \brief Accumulates the lengths of the subranges found in each dimension
+ * of a nested range. The histogram of the lengths, needed only by
+ * `statistics()`, is kept only if `withStatistics` is true.
+ * \ingroup detail
+ */
+class BoundsAccumulator {
+public:
+    BoundsAccumulator(size_t dimensionality, bool withStatistics) :
+        maxLength_(dimensionality, 0),
+        subrangeCount_(dimensionality, 0),
+        totalLength_(dimensionality, 0),
+        lengthCounts_(withStatistics ? dimensionality : 0)
+    {}
+
+    void add(size_t dimension, size_t length) {
+        if (maxLength_[dimension] < length) maxLength_[dimension] = length;
+        ++subrangeCount_[dimension];
+        totalLength_[dimension] += length;
+        if (!lengthCounts_.empty()) ++lengthCounts_[dimension][length];
+    }
+
+    void merge(const BoundsAccumulator& other) {
+        for (size_t dimension = 0; dimension < maxLength_.size(); ++dimension) {
+            if (maxLength_[dimension] < other.maxLength_[dimension]) {
+                maxLength_[dimension] = other.maxLength_[dimension];
+            }
+            subrangeCount_[dimension] += other.subrangeCount_[dimension];
+            totalLength_[dimension] += other.totalLength_[dimension];
+            if (lengthCounts_.empty() || other.lengthCounts_.empty()) continue;
+            for (const auto& lengthCount : other.lengthCounts_[dimension]) {
+                lengthCounts_[dimension][lengthCount.first] += lengthCount.second;
+            }
+        }
+    }
+
+    // Replaces the data of the outermost dimension, which consists
+    // in a single range of size `length`
+    void setOuterLength(size_t length) {
+        maxLength_[0] = length;
+        subrangeCount_[0] = 1;
+        totalLength_[0] = length;
+        if (lengthCounts_.empty()) return;
+        lengthCounts_[0].clear();
+        lengthCounts_[0][length] = 1;
+    }
+
+    const std::vector<size_t>& bounds() const {return maxLength_;}
+
+    std::vector<BoundsStatistics> statistics() const {
+        std::vector<BoundsStatistics> result(maxLength_.size());
+        double boxSubranges = 1;
+            // number of subranges of this dimension in the bounding box
+        for (size_t dimension = 0; dimension < maxLength_.size(); ++dimension) {
+            auto& statistics = result[dimension];
+            const size_t count = subrangeCount_[dimension];
+            if (count > 0) {
+                statistics.averageLength =
+                    static_cast<double>(totalLength_[dimension]) / count;
+
+                // smallest length such that 99% of the subranges are not longer
+                const size_t threshold = count - count / 100;
+                size_t cumulatedCount = 0;
+                for (const auto& lengthCount : lengthCounts_.at(dimension)) {
+                    cumulatedCount += lengthCount.second;
+                    if (cumulatedCount >= threshold) {
+                        statistics.p99Length = lengthCount.first;
+                        break;
+                    }
+                }
+            }
+
+            const double boxElements = boxSubranges * maxLength_[dimension];
+            if (boxElements > 0) {
+                statistics.paddingRatio = 1.0 - totalLength_[dimension] / boxElements;
+            }
+            boxSubranges = boxElements;
+        }
+        return result;
+    }
+
+private:
+    std::vector<size_t> maxLength_;
+    std::vector<size_t> subrangeCount_;
+    std::vector<size_t> totalLength_;
+    std::vector<std::map<size_t, size_t>> lengthCounts_;
+        // length -> number of subranges having such length,
+        // for each dimension (empty if no statistics are requested)
+};
+
+// Version for monolevel ranges
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    typename std::enable_if<
+        (true == IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value),
+        long
+    >::type = 0xBEEF
+>
+void accumulateBounds(Iterator first, Iterator last, size_t dimension, BoundsAccumulator& accumulator) {
+    accumulator.add(dimension, static_cast<size_t>(std::distance(first, last)));
+}
+
+// Version for multilevel ranges
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    typename std::enable_if<
+        (false == IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value),
+        int
+    >::type = 0xBEEF
+>
+void accumulateBounds(Iterator first, Iterator last, size_t dimension, BoundsAccumulator& accumulator) {
+    size_t length = 0;
+    for (auto it = first; it != last; ++it) {
+        accumulateBounds<ScalarPolicy>(begin(*it), end(*it), dimension + 1, accumulator);
+        ++length;
+    }
+    accumulator.add(dimension, length);
+}
+
+/** \fn parallelBounds(Iterator first, Iterator last, Executor& executor, std::vector<BoundsStatistics>* statistics)
+ * \brief Returns the same result as `bounds`, computed in parallel
+ * by splitting the outermost dimension among the threads of `executor`.
+ * Optionally, collects statistics about the lengths of the subranges
+ * in each dimension, e.g. to decide if clipping the bounds of a BoxedView
+ * to the 99th percentile would save memory.
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ * \param first, last the range whose bounds will be returned
+ * \param executor (optional) the executor running the computation
+ * \param statistics (optional) if not null, will be filled with
+ *  the statistics of each dimension (the padding ratio refers to the
+ *  bounds of the range, as returned by this function)
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Iterator = void
+>
+std::vector<size_t> parallelBounds(
+    Iterator first, Iterator last,
+    Executor& executor = defaultExecutor(),
+    std::vector<BoundsStatistics>* statistics = nullptr
+) {
+    constexpr size_t rangeDimensionality = DimensionalityRange<ScalarPolicy, Iterator>::value;
+    constexpr size_t minChunkSize = 16;
+        // elements of the outermost dimension, below that a thread is not worth
+    const size_t outerSize = static_cast<size_t>(std::distance(first, last));
+    const size_t chunkCount = parallelChunkCount(executor, outerSize, minChunkSize);
+
+    std::vector<Iterator> chunkFirsts{first};
+    for (size_t chunk = 1; chunk <= chunkCount; ++chunk) {
+        auto chunkFirst = chunkFirsts.back();
+        std::advance(
+            chunkFirst,
+            outerSize * chunk / chunkCount - outerSize * (chunk - 1) / chunkCount
+        );
+        chunkFirsts.push_back(chunkFirst);
+    }
+
+    std::vector<BoundsAccumulator> accumulators(
+        chunkCount, BoundsAccumulator{rangeDimensionality, statistics != nullptr}
+    );
+    parallelChunks(executor, outerSize, chunkCount,
+        [&](size_t chunk, size_t, size_t) {
+            accumulateBounds<ScalarPolicy>(
+                chunkFirsts[chunk], chunkFirsts[chunk + 1], 0, accumulators[chunk]
+            );
+        }
+    );
+
+    BoundsAccumulator result{rangeDimensionality, statistics != nullptr};
+    for (const auto& accumulator : accumulators) result.merge(accumulator);
+    result.setOuterLength(outerSize);
+
+    if (statistics != nullptr) *statistics = result.statistics();
+    return result.bounds();
+}
+
+/** \brief Returns the same result as `bounds`, computed in parallel,
+ *  see the range version
+ * \ingroup user_functions
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void
+>
+std::vector<size_t> parallelBounds(
+    const Container& container,
+    Executor& executor = defaultExecutor(),
+    std::vector<BoundsStatistics>* statistics = nullptr
+) {
+    return parallelBounds<ScalarPolicy>(
+        begin(container), end(container), executor, statistics
+    );
+}
+
+} // namespace multidim - Executor
+
 
 // **************************************************************************
 // **************************************************************************
@@ -602,6 +1328,32 @@ auto operator+(
         const FlatViewIterator<ScalarPolicy, RawIterator, isConstIterator>& other)
     -> FlatViewIterator<ScalarPolicy, RawIterator, isConstIterator>;
 
+// forward declaration of TransformedFlatView, see FlatView::project
+template <template<typename> class ScalarPolicy, typename RawIterator, typename Function>
+class TransformedFlatView;
+
+//***************************************************************************
+// MemberProjection
+//***************************************************************************
+/** \brief A function object returning a data member of its argument.
+ * The member is returned by reference, unless the argument is a temporary
+ * (e.g. the value returned by a const FlatViewIterator).
+ * \ingroup flat_view_adaptors
+ */
+template <typename Class, typename Member>
+class MemberProjection {
+public:
+    explicit MemberProjection(Member Class::* member) : member_{member} {}
+
+    Member& operator()(Class& object) const {return object.*member_;}
+    const Member& operator()(const Class& object) const {return object.*member_;}
+    Member operator()(Class&& object) const {return object.*member_;}
+    Member operator()(const Class&& object) const {return object.*member_;}
+
+private:
+    Member Class::* member_;
+};
+
 // **************************************************************************
 
 //***************************************************************************
@@ -646,18 +1398,18 @@ public:
     bool operator<=(const FlatView& other) const {return !(*this > other);}
     bool operator>=(const FlatView& other) const {return !(other > *this);}
 
-    iterator begin() {return iterator::makeBegin(begin_, end_);}
-    const_iterator begin() const {return const_iterator::makeBegin(begin_, end_);}
-    const_iterator cbegin() const {return const_iterator::makeBegin(begin_, end_);}
-    iterator end() {return iterator::makeEnd(begin_, end_);}
-    const_iterator end() const {return const_iterator::makeEnd(begin_, end_);}
-    const_iterator cend() const {return const_iterator::makeEnd(begin_, end_);}
-    reverse_iterator rbegin() {return reverse_iterator{iterator::makeEnd(begin_, end_)};}
-    const_reverse_iterator rbegin() const {return const_reverse_iterator{const_iterator::makeEnd(begin_, end_)};}
-    const_reverse_iterator crbegin() const {return const_reverse_iterator{const_iterator::makeEnd(begin_, end_)};}
-    reverse_iterator rend() {return reverse_iterator{iterator::makeBegin(begin_, end_)};}
-    const_reverse_iterator rend() const {return const_reverse_iterator{const_iterator::makeBegin(begin_, end_)};}
-    const_reverse_iterator crend() const {return const_reverse_iterator{const_iterator::makeBegin(begin_, end_)};}
+    iterator begin() {return hasPositions_ ? first_ : iterator::makeBegin(begin_, end_);}
+    const_iterator begin() const {return hasPositions_ ? first_ : iterator::makeBegin(begin_, end_);}
+    const_iterator cbegin() const {return begin();}
+    iterator end() {return hasPositions_ ? last_ : iterator::makeEnd(begin_, end_);}
+    const_iterator end() const {return hasPositions_ ? last_ : iterator::makeEnd(begin_, end_);}
+    const_iterator cend() const {return end();}
+    reverse_iterator rbegin() {return reverse_iterator{end()};}
+    const_reverse_iterator rbegin() const {return const_reverse_iterator{end()};}
+    const_reverse_iterator crbegin() const {return const_reverse_iterator{end()};}
+    reverse_iterator rend() {return reverse_iterator{begin()};}
+    const_reverse_iterator rend() const {return const_reverse_iterator{begin()};}
+    const_reverse_iterator crend() const {return const_reverse_iterator{begin()};}
 
     reference front() {return *begin();}
     const_reference front() const {return *cbegin();}
@@ -670,8 +1422,9 @@ public:
     void swap(const FlatView& other) {std::swap(*this, other);}
     size_type size() const {
         // size should be constant, I guess that amortized constant will do
+        // (the size of a part is always known, see split())
         if (cachedSize_ == NO_VALUE) {
-            cachedSize_ = std::distance(begin(), end());
+            cachedSize_ = scalarSize<ScalarPolicy>(begin_, end_);
         }
         return cachedSize_;
     }
@@ -681,13 +1434,119 @@ public:
 
     bool empty() const {return (size() == 0);}
 
-private:
-    bool equal(const FlatView& other) const {
-        return (size() == other.size()) &&
-               std::equal(begin(), end(), other.begin());
+    // **************************************************************************
+    // Cached positions
+    // **************************************************************************
+    /** \brief Makes the View find its first and last positions once,
+     * instead of at every call to begin() and end().
+     * Finding the first scalar element requires skipping the leading empty
+     * subranges at every level, which is worth avoiding when a View
+     * of a mostly empty range is traversed many times.
+     * Once the positions are cached, `rebuild` must be called whenever
+     * the structure of the underlying range changes (i.e. subranges are
+     * added, removed or resized).
+     * \return the View itself
+     */
+    FlatView& cachePositions() {
+        if (!isPart_) {
+            hasPositions_ = true;
+            rebuild();
+        }
+        return *this;
     }
 
-    bool compare(const FlatView& other) const {
+    /** \brief Recomputes the cached positions (if any, see `cachePositions`)
+     * and size of the View, after a change of the structure of the
+     * underlying range.
+     * \note It has no effect on the parts built by split(), whose
+     *  positions are fixed: split the rebuilt View again instead.
+     */
+    void rebuild() {
+        if (isPart_) return;
+        if (hasPositions_) {
+            first_ = iterator::makeBegin(begin_, end_);
+            last_ = iterator::makeEnd(begin_, end_);
+        }
+        cachedSize_ = NO_VALUE;
+    }
+
+    // **************************************************************************
+    // Splitting
+    // **************************************************************************
+    /** \brief Splits the View in `partCount` consecutive parts, holding
+     * the same number of scalar elements (up to one).
+     * Each part is a FlatView on the same range, restricted to a subset of
+     * its positions. The parts are located using the scalarSize
+     * of the subranges, descending only in the subranges where a part
+     * begins, so the scalar elements are not visited one by one.
+     * Intended for parallel frameworks, in the spirit of TBB's `blocked_range`.
+     * \param partCount number of parts, must be > 0 (parts may be empty)
+     */
+    std::vector<FlatView> split(size_t partCount) const {
+        if (partCount == 0) {
+            throw std::runtime_error("FlatView::split : cannot split in 0 parts");
+        }
+
+        const size_t totalSize = size();
+        std::vector<FlatView> parts;
+        parts.reserve(partCount);
+
+        iterator partBegin = hasPositions_ ? first_ : iterator::makeBegin(begin_, end_);
+        size_t partBeginIndex = 0;
+        for (size_t part = 0; part < partCount; ++part) {
+            const size_t partEndIndex = totalSize * (part + 1) / partCount;
+            iterator partEnd = partBegin + static_cast<difference_type>(partEndIndex - partBeginIndex);
+            parts.push_back(FlatView{begin_, end_, partBegin, partEnd, partEndIndex - partBeginIndex});
+            partBegin = partEnd;
+            partBeginIndex = partEndIndex;
+        }
+
+        return parts;
+    }
+
+    // **************************************************************************
+    // Projection
+    // **************************************************************************
+    /** \brief Returns a TransformedFlatView showing the data member `member`
+     * of each scalar element, e.g. `view.project(&Point::x)`.
+     * The members are returned by reference, so they can be modified
+     * through the returned View (unless the underlying range is const).
+     */
+    template <typename Class, typename Member>
+    TransformedFlatView<ScalarPolicy, RawIterator, MemberProjection<Class, Member>>
+    project(Member Class::* member) const {
+        return TransformedFlatView<ScalarPolicy, RawIterator, MemberProjection<Class, Member>>{
+            *this, MemberProjection<Class, Member>{member}
+        };
+    }
+
+    // **************************************************************************
+    // Access to the underlying range
+    // **************************************************************************
+    /** \brief The whole underlying range: a part built by split()
+     * still returns the range it was split from, see `isPart`.
+     */
+    RawIterator rawBegin() const {return begin_;}
+    RawIterator rawEnd() const {return end_;}
+    bool isPart() const {return isPart_;}  /**< true if the View was built by split() */
+
+private:
+    // Constructor of the parts made by split()
+    FlatView(
+        RawIterator first, RawIterator last,
+        iterator partBegin, iterator partEnd, size_t partSize
+    ) :
+        begin_{first}, end_{last},
+        cachedSize_{partSize},
+        isPart_{true}, hasPositions_{true}, first_{partBegin}, last_{partEnd}
+    {}
+
+    bool equal(const FlatView& other) const {
+        return (size() == other.size()) &&
+               std::equal(begin(), end(), other.begin());
+    }
+
+    bool compare(const FlatView& other) const {
         return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
     }
 
@@ -695,6 +1554,13 @@ private:
     RawIterator begin_ = nullptr;
     RawIterator end_ = nullptr;
     mutable size_t cachedSize_ = NO_VALUE;
+    bool isPart_ = false;
+        // if true, the View was built by split()
+    bool hasPositions_ = false;
+        // if true, begin() and end() return first_ and last_
+        // (always the case for the parts)
+    iterator first_;
+    iterator last_;
 };
 
 
@@ -720,6 +1586,33 @@ auto makeFlatView(Iterator first, Iterator last) -> FlatView<ScalarPolicy, Itera
     return FlatView<ScalarPolicy, Iterator>{first, last};
 }
 
+//***************************************************************************
+// forEachSegment
+//***************************************************************************
+/** \brief Calls `function(first, count)` for each segment of the View, i.e.
+ * for each run of scalar elements which are adjacent in the underlying
+ * container: `first` is the raw iterator of the first element of the run.
+ * Used by the algorithms which can process a run with a plain loop.
+ * \ingroup detail
+ */
+template <typename Iterator, typename Function>
+void forEachSegment(Iterator cursor, size_t left, Function&& function) {
+    while (left > 0) {
+        auto first = cursor.segmentBegin();
+        const size_t count = std::min(
+            static_cast<size_t>(std::distance(first, cursor.segmentEnd())), left
+        );
+        function(first, count);
+        left -= count;
+        if (left > 0) cursor.nextSegment();
+    }
+}
+
+template <template<typename> class ScalarPolicy, typename RawIterator, typename Function>
+void forEachSegment(const FlatView<ScalarPolicy, RawIterator>& view, Function&& function) {
+    forEachSegment(view.begin(), view.size(), std::forward<Function>(function));
+}
+
 //***************************************************************************
 // FlatViewIterator
 //***************************************************************************
@@ -751,7 +1644,7 @@ public:
     // **************************************************************************
     // ctors
     // **************************************************************************
-    FlatViewIterator() : child_{}, begin_{nullptr}, current_{nullptr}, end_{nullptr} {}
+    FlatViewIterator() : child_{}, begin_{}, current_{}, end_{} {}
     /* \brief Default constructor. */
 
     FlatViewIterator(const FlatViewIterator&) = default;
@@ -809,7 +1702,7 @@ public:
 
     // **************************************************************************
 
-    bool valid() const {return (current_ < end_) && (child_.valid());}
+    bool valid() const {return (current_ != end_) && (child_.valid());}
 
 private: // funcs
     using ChildRawIterator = typename IteratorType<typename std::iterator_traits<RawIterator>::reference>::type;
@@ -817,6 +1710,9 @@ private: // funcs
 
     // needed for conversion to const_iterator
     friend class FlatViewIterator<ScalarPolicy, RawIterator, true, true>;
+    // needed to move the subordinate iterators
+    template <template<typename> class, typename, bool, bool>
+    friend class FlatViewIterator;
 
     FlatViewIterator(RawIterator first, RawIterator last, Forward)
         : begin_{first}
@@ -878,10 +1774,42 @@ private: // funcs
     }
 
     void advance(difference_type n) {
-        if (n > 0) for (difference_type i = 0; i < n; ++i) ++(*this);
+        if (n > 0) skip(static_cast<size_t>(n));
         if (n < 0) for (difference_type i = 0; i > n; --i) --(*this);
     }
 
+    // Moves forward by n scalar elements. Whole subranges are jumped
+    // using their scalarSize, instead of visiting their elements.
+    // Returns the number of steps which could not be performed
+    // since the end was reached
+    size_t skip(size_t n) {
+        if (!valid() && current_ != end_) {
+            // "one before the first": the first step leads to the first element
+            if (n == 0) return 0;
+            increment();
+            --n;
+        }
+
+        if (valid()) {
+            n = child_.skip(n);
+            if (child_.valid()) return 0;
+            ++current_;
+        }
+
+        // current_ is at the beginning of a subrange,
+        // the first n scalar elements are to be jumped
+        while (current_ != end_) {
+            const size_t subrangeSize = scalarSize<ScalarPolicy>(*current_);
+            if (n < subrangeSize) {
+                child_ = ChildIterator::makeBegin(begin(*current_), end(*current_));
+                return child_.skip(n);
+            }
+            n -= subrangeSize;
+            ++current_;
+        }
+        return n;
+    }
+
     reference dereference() const {
         if (!valid()) throw std::runtime_error("FlatViewIterator: access out of bounds");
         return *child_;
@@ -925,6 +1853,25 @@ private: // funcs
         );
     }
 
+public:
+    // **************************************************************************
+    // Segment access
+    // **************************************************************************
+    // A segment is the part of a bottom-level subrange which starts at the
+    // current position: its scalars are adjacent in the underlying container,
+    // so an algorithm can process them with a plain loop on the raw iterators.
+    // These members require valid() == true
+    using SegmentIterator = typename ChildIterator::SegmentIterator;
+    SegmentIterator segmentBegin() const {return child_.segmentBegin();}
+    SegmentIterator segmentEnd() const {return child_.segmentEnd();}
+
+    // Moves to the first scalar element after the current segment
+    void nextSegment() {
+        child_.nextSegment();
+        if (child_.valid()) return;
+        ++current_;
+        increment();
+    }
 
 private: // members
     ChildIterator child_;
@@ -1018,6 +1965,9 @@ public:
 private: // funcs
     // needed for conversion to const_iterator
     friend class FlatViewIterator<ScalarPolicy, RawIterator, true, false>;
+    // needed to move the subordinate iterators
+    template <template<typename> class, typename, bool, bool>
+    friend class FlatViewIterator;
 
     // **************************************************************************
     // private ctors
@@ -1053,10 +2003,30 @@ private: // funcs
     }
 
     void advance(difference_type n) {
-        if (n > 0) for (difference_type i = 0; i < n; ++i) ++(*this);
+        if (n > 0) skip(static_cast<size_t>(n));
         if (n < 0) for (difference_type i = 0; i > n; --i) --(*this);
     }
 
+    // Moves forward by n scalar elements, see the other specialization
+    size_t skip(size_t n) {
+        if (!valid_ && current_ != end_) {
+            // "one before the first": the first step leads to the first element
+            if (n == 0) return 0;
+            increment();
+            --n;
+        }
+
+        const size_t remaining = static_cast<size_t>(std::distance(current_, end_));
+        if (n < remaining) {
+            std::advance(current_, n);
+            valid_ = true;
+            return 0;
+        }
+        current_ = end_;
+        valid_ = false;
+        return n - remaining;
+    }
+
     reference dereference() const {
         if (!valid_) throw std::runtime_error("FlatViewIterator: access out of bounds");
         return *current_;
@@ -1098,6 +2068,15 @@ private: // funcs
         );
     }
 
+public:
+    // **************************************************************************
+    // Segment access, see the other specialization
+    // **************************************************************************
+    using SegmentIterator = RawIterator;
+    SegmentIterator segmentBegin() const {return current_;}
+    SegmentIterator segmentEnd() const {return end_;}
+    void nextSegment() {current_ = end_; valid_ = false;}
+
 private: // members
     bool valid_;
     RawIterator begin_;
@@ -1158,6 +2137,133 @@ class BoxedViewScalarProxy;
 
 // **************************************************************************
 
+//***************************************************************************
+// CooData
+//***************************************************************************
+/** \brief The cells of a sparse D-dimensional array in coordinate (COO)
+ * format, as a structure of arrays: the n-th cell has the coordinates
+ * `indices[0][n], ..., indices[D - 1][n]` and the value `values[n]`.
+ * See `BoxedView::toCoo`.
+ * \ingroup boxed_view
+ */
+template <typename T, size_t dimensionality>
+struct CooData {
+    std::array<std::vector<size_t>, dimensionality> indices;
+        /**< the coordinates of the cells, one array for each dimension */
+    std::vector<T> values;
+        /**< the values of the cells */
+
+    /** \brief The number of cells */
+    size_t size() const {return values.size();}
+    void resize(size_t cellCount) {
+        for (auto& coordinates : indices) coordinates.resize(cellCount);
+        values.resize(cellCount);
+    }
+};
+
+//***************************************************************************
+// cooVisit
+//***************************************************************************
+// Calls function(index, value) for the physical elements of [first, last)
+// within `bounds`, index[level] going from `firstIndex`
+
+// Version for monolevel ranges
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    size_t dimensionality,
+    typename Function,
+    typename std::enable_if<
+        IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value,
+        long
+    >::type = 0xBEEF
+>
+void cooVisit(
+    Iterator first, Iterator last, const size_t* bounds,
+    std::array<size_t, dimensionality>& index, size_t level, size_t firstIndex,
+    Function& function
+) {
+    auto& position = index[level];
+    for (position = firstIndex; first != last && position < bounds[level]; ++first, ++position) {
+        function(const_cast<const std::array<size_t, dimensionality>&>(index), *first);
+    }
+}
+
+// Version for multilevel ranges
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    size_t dimensionality,
+    typename Function,
+    typename std::enable_if<
+        (false == IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value),
+        int
+    >::type = 0xBEEF
+>
+void cooVisit(
+    Iterator first, Iterator last, const size_t* bounds,
+    std::array<size_t, dimensionality>& index, size_t level, size_t firstIndex,
+    Function& function
+) {
+    for (index[level] = firstIndex; first != last && index[level] < bounds[level]; ++first, ++index[level]) {
+        cooVisit<ScalarPolicy>(begin(*first), end(*first), bounds, index, level + 1, 0, function);
+    }
+}
+
+//***************************************************************************
+// denseVisit
+//***************************************************************************
+// Visits [first, last) as a box of bounds `bounds`, in row-major order:
+// calls visitor.segment(first, count) for each run of physical scalar
+// elements and visitor.padding(value, count) for each run of missing ones;
+// boxSizes[level] is the number of scalar elements of a subrange of `level`
+
+// Version for monolevel ranges
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    typename ScalarType,
+    typename Visitor,
+    typename std::enable_if<
+        IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value,
+        long
+    >::type = 0xBEEF
+>
+void denseVisit(
+    Iterator first, Iterator last, const size_t* bounds, const size_t*,
+    size_t level, const ScalarType& defaultValue, Visitor& visitor
+) {
+    const size_t count = std::min(static_cast<size_t>(std::distance(first, last)), bounds[level]);
+    if (count > 0) visitor.segment(first, count);
+    if (count < bounds[level]) visitor.padding(defaultValue, bounds[level] - count);
+}
+
+// Version for multilevel ranges
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    typename ScalarType,
+    typename Visitor,
+    typename std::enable_if<
+        (false == IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value),
+        int
+    >::type = 0xBEEF
+>
+void denseVisit(
+    Iterator first, Iterator last, const size_t* bounds, const size_t* boxSizes,
+    size_t level, const ScalarType& defaultValue, Visitor& visitor
+) {
+    size_t index = 0;
+    for (; first != last && index < bounds[level]; ++first, ++index) {
+        denseVisit<ScalarPolicy>(begin(*first), end(*first), bounds, boxSizes, level + 1, defaultValue, visitor);
+    }
+    // The missing subranges are padded in a single run
+    if (index < bounds[level] && boxSizes[level] > 0) {
+        visitor.padding(defaultValue, (bounds[level] - index) * boxSizes[level]);
+    }
+}
+
+
 //***************************************************************************
 // BoxedView
 //***************************************************************************
@@ -1287,11 +2393,8 @@ public:
 
     void swap(const BoxedView& other) {std::swap(*this, other);}
     size_type size() const {
-        // size should be constant, I guess that amortized constant will do
-        if (cachedSize_ == NO_VALUE) {
-            cachedSize_ = std::distance(begin_, end_);
-        }
-        return cachedSize_;
+        // the apparent size, not the physical one
+        return bounds_[0];
     }
     size_type max_size() const {return std::numeric_limits<size_type>::max();};
      /**<  \note Since C++17 the result of max_size should be divided
@@ -1301,6 +2404,154 @@ public:
 
     bool empty() const {return (size() == 0);}
 
+    /** \brief The bounds of the View, i.e. the same result as `bounds(view)`,
+     * but without visiting the subranges */
+    std::vector<size_t> viewBounds() const {
+        return std::vector<size_t>(std::begin(bounds_), std::end(bounds_));
+    }
+
+    // **************************************************************************
+    // Sparse export
+    // **************************************************************************
+    /** \brief Returns the coordinates and the values of the elements
+     * which are physically present and differ from the default value,
+     * in row-major order.
+     * Only the physical subranges (within the bounds) are visited,
+     * instead of the whole box, so the cost depends on the size
+     * of the data, not of the View.
+     * The outermost dimension is split among the threads of `executor`:
+     * a first pass counts the cells of each chunk, so that the second one
+     * writes them directly in their place in the result.
+     * \param executor (optional) the executor running the computation
+     */
+    CooData<ScalarType, dimensionality_> toCoo(Executor& executor = defaultExecutor()) const {
+        using Index = std::array<size_t, dimensionality_>;
+        constexpr size_t minChunkSize = 16;
+        const size_t rowCount = std::min(
+            bounds_[0], static_cast<size_t>(std::distance(begin_, end_))
+        );
+        const size_t chunkCount = parallelChunkCount(executor, rowCount, minChunkSize);
+
+        std::vector<RawIterator> chunkFirsts{begin_};
+        for (size_t chunk = 1; chunk <= chunkCount; ++chunk) {
+            auto chunkFirst = chunkFirsts.back();
+            std::advance(
+                chunkFirst,
+                rowCount * chunk / chunkCount - rowCount * (chunk - 1) / chunkCount
+            );
+            chunkFirsts.push_back(chunkFirst);
+        }
+
+        std::vector<size_t> chunkOffsets(chunkCount + 1, 0);
+        parallelChunks(executor, rowCount, chunkCount,
+            [&](size_t chunk, size_t chunkBegin, size_t) {
+                Index index;
+                size_t count = 0;
+                auto counter = [&](const Index&, const ScalarType& value) {
+                    if (!(value == defaultValue_)) ++count;
+                };
+                cooVisit<ScalarPolicy>(
+                    chunkFirsts[chunk], chunkFirsts[chunk + 1], bounds_,
+                    index, 0, chunkBegin, counter
+                );
+                chunkOffsets[chunk + 1] = count;
+            }
+        );
+        std::partial_sum(chunkOffsets.begin(), chunkOffsets.end(), chunkOffsets.begin());
+
+        CooData<ScalarType, dimensionality_> result;
+        result.resize(chunkOffsets.back());
+        parallelChunks(executor, rowCount, chunkCount,
+            [&](size_t chunk, size_t chunkBegin, size_t) {
+                Index index;
+                size_t position = chunkOffsets[chunk];
+                auto writer = [&](const Index& cellIndex, const ScalarType& value) {
+                    if (value == defaultValue_) return;
+                    for (size_t d = 0; d < dimensionality_; ++d) {
+                        result.indices[d][position] = cellIndex[d];
+                    }
+                    result.values[position] = value;
+                    ++position;
+                };
+                cooVisit<ScalarPolicy>(
+                    chunkFirsts[chunk], chunkFirsts[chunk + 1], bounds_,
+                    index, 0, chunkBegin, writer
+                );
+            }
+        );
+        return result;
+    }
+
+    // **************************************************************************
+    // Dense export
+    // **************************************************************************
+    /** \brief Visits the whole box in row-major order, by runs:
+     * calls `visitor.segment(first, count)` for each run of physical
+     * scalar elements (`first` being an iterator of the underlying leaf
+     * subrange) and `visitor.padding(defaultValue, count)` for each run
+     * of defaulted ones, so that both can be processed in bulk
+     * (see `convert`). The missing subranges of a level make a single
+     * padding run.
+     * \param visitor the object receiving the runs
+     */
+    template <typename Visitor>
+    void visitDense(Visitor& visitor) const {
+        size_t boxSizes[dimensionality_];
+        boxSizes[dimensionality_ - 1] = 1;
+        for (size_t d = dimensionality_ - 1; d > 0; --d) {
+            boxSizes[d - 1] = boxSizes[d] * bounds_[d];
+        }
+        denseVisit<ScalarPolicy>(begin_, end_, bounds_, boxSizes, 0, defaultValue_, visitor);
+    }
+
+    // **************************************************************************
+    // Splitting
+    // **************************************************************************
+    /** \brief Splits the View in `partCount` BoxedViews, each one spanning
+     * a block of consecutive elements of the outermost dimension.
+     * Since all the elements of a BoxedView have the same bounds,
+     * the blocks hold the same number of elements (up to one),
+     * and thus the same number of scalar elements.
+     * Each part is a BoxedView on a subrange of the same range,
+     * having the same default value and inner bounds.
+     * \param partCount number of parts, must be > 0 (parts may be empty)
+     * \note The parts cannot be smaller than an element of the outermost
+     *  dimension, so if `partCount` exceeds the outermost bound,
+     *  some of them will be empty
+     */
+    std::vector<BoxedView> split(size_t partCount) const {
+        if (partCount == 0) {
+            throw std::runtime_error("BoxedView::split : cannot split in 0 parts");
+        }
+
+        const size_t physicalSize = static_cast<size_t>(std::distance(begin_, end_));
+        std::vector<BoxedView> parts;
+        parts.reserve(partCount);
+
+        auto partFirst = begin_;
+        size_t partBeginIndex = 0;
+        for (size_t part = 0; part < partCount; ++part) {
+            const size_t partEndIndex = bounds_[0] * (part + 1) / partCount;
+            // The elements beyond the physical size of the range
+            // are defaulted by the part too
+            auto partLast = partFirst;
+            if (partEndIndex > partBeginIndex && partBeginIndex < physicalSize) {
+                std::advance(
+                    partLast,
+                    std::min(partEndIndex, physicalSize) - partBeginIndex
+                );
+            }
+
+            parts.push_back(BoxedView{partFirst, partLast, defaultValue_, bounds_});
+            parts.back().bounds_[0] = partEndIndex - partBeginIndex;
+
+            partFirst = partLast;
+            partBeginIndex = partEndIndex;
+        }
+
+        return parts;
+    }
+
 private:
     bool equal(const BoxedView& other) const {
         return (begin_ == other.begin_)
@@ -1321,7 +2572,6 @@ private:
 private:
     RawIterator begin_ = nullptr;
     RawIterator end_ = nullptr;
-    mutable size_t cachedSize_ = NO_VALUE;
     ScalarType defaultValue_;
     size_t bounds_[dimensionality_] = {0};
 
@@ -1330,10 +2580,63 @@ private:
 //***************************************************************************
 // makeBoxedView
 //***************************************************************************
+// Builds a BoxedView, see makeBoxedView. If no bounds are given,
+// the bounds of the range are computed sequentially, unless an executor
+// is given (or statistics are requested, which only parallelBounds collects)
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    typename ScalarValue,
+    typename BoundsIterator
+>
+auto makeBoxedViewFrom(
+    Iterator first, Iterator last, ScalarValue&& defaultValue,
+    BoundsIterator boundsFirst, BoundsIterator boundsLast,
+    Executor* executor, std::vector<BoundsStatistics>* statistics
+)
+    -> BoxedView<
+        ScalarPolicy, Iterator,
+        DimensionalityRange<ScalarPolicy, Iterator>::value
+       >
+{
+    constexpr size_t viewDimensionality = DimensionalityRange<ScalarPolicy, Iterator>::value;
+
+    if (boundsFirst == boundsLast || statistics != nullptr) {
+        std::vector<size_t> containerBounds;
+        if (executor == nullptr && statistics == nullptr) {
+            containerBounds = bounds<ScalarPolicy>(first, last);
+        } else {
+            SerialExecutor serial;
+            containerBounds = parallelBounds<ScalarPolicy>(
+                first, last, (executor != nullptr) ? *executor : serial, statistics
+            );
+        }
+        if (boundsFirst == boundsLast) {
+            return BoxedView<ScalarPolicy, Iterator, viewDimensionality>
+                ( first, last,
+                  std::forward<ScalarValue>(defaultValue), containerBounds.begin()
+                 );
+        }
+    }
+
+    if (std::distance(boundsFirst, boundsLast) != viewDimensionality) {
+        throw std::runtime_error("makeBoxedView : limit list has false size");
+    }
+
+    return BoxedView<ScalarPolicy, Iterator, viewDimensionality>
+        (first, last, std::forward<ScalarValue>(defaultValue), boundsFirst);
+}
+
 /** \brief Factory method to build a BoxedView of a range
  * \ingroup user_functions
  * \param ScalarPolicy : (trait template)
  * \param first, last the range on which the View will be based
+ * \param defaultValue the value of the elements outside the physical range
+ * \param viewBounds the bounds of the View, or an empty list to use
+ *  the bounds of the range (computed sequentially: pass an Executor
+ *  to compute them in parallel, see `parallelBounds`)
+ * \param statistics (optional) if not null, will be filled with
+ *  statistics on the lengths of the subranges, see `parallelBounds`
  */
 template <
     template<typename> class ScalarPolicy = NoCustomScalars,
@@ -1343,7 +2646,8 @@ template <
 >
 auto makeBoxedView(
     Iterator first, Iterator last,
-    ScalarValue&& defaultValue, const BoundsContainer& viewBounds
+    ScalarValue&& defaultValue, const BoundsContainer& viewBounds,
+    std::vector<BoundsStatistics>* statistics = nullptr
 )
     -> BoxedView<
         ScalarPolicy, Iterator,
@@ -1351,23 +2655,10 @@ auto makeBoxedView(
        >
 {
     using std::begin;
-    if (begin(viewBounds) ==  end(viewBounds)) {
-        auto containerBounds = bounds<ScalarPolicy>(first, last);
-        return BoxedView<ScalarPolicy, Iterator, dimensionality(first, last)>
-            ( first, last,
-              std::forward<ScalarValue>(defaultValue), begin(containerBounds)
-             );
-    }
-
-    if (
-        std::distance(begin(viewBounds), end(viewBounds)) !=
-        dimensionality(first, last)
-    ) {
-        throw std::runtime_error("makeBoxedView : limit list has false size");
-    }
-
-    return BoxedView<ScalarPolicy, Iterator, dimensionality(first, last)>
-        (first, last, std::forward<ScalarValue>(defaultValue), begin(viewBounds));
+    return makeBoxedViewFrom<ScalarPolicy>(
+        first, last, std::forward<ScalarValue>(defaultValue),
+        begin(viewBounds), end(viewBounds), nullptr, statistics
+    );
 }
 
 // The same, with a initializer list
@@ -1378,32 +2669,69 @@ template <
 >
 auto makeBoxedView(
     Iterator first, Iterator last,
-    ScalarValue&& defaultValue, std::initializer_list<size_t> viewBounds
+    ScalarValue&& defaultValue, std::initializer_list<size_t> viewBounds,
+    std::vector<BoundsStatistics>* statistics = nullptr
 )
     -> BoxedView<
         ScalarPolicy, Iterator,
         DimensionalityRange<ScalarPolicy, Iterator>::value
        >
 {
-    using std::begin;
-    if (begin(viewBounds) == end(viewBounds)) {
-        auto containerBounds = bounds<ScalarPolicy>(first, last);
-        return BoxedView<ScalarPolicy, Iterator, dimensionality(first, last)>
-            (first, last,
-             std::forward<ScalarValue>(defaultValue), begin(containerBounds)
-            );
-    }
-
-    if (
-        std::distance(begin(viewBounds), end(viewBounds)) !=
-        dimensionality(first, last)
-    ) {
-        throw std::runtime_error("makeBoxedView : limit list has false size");
+    return makeBoxedViewFrom<ScalarPolicy>(
+        first, last, std::forward<ScalarValue>(defaultValue),
+        viewBounds.begin(), viewBounds.end(), nullptr, statistics
+    );
+}
 
-    }
+/** \brief The same, computing the bounds of the range (if they are needed)
+ * in parallel on `executor`, see `parallelBounds`
+ * \param executor the executor running the computation of the bounds
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Iterator = void,
+    typename ScalarValue = void,
+    typename BoundsContainer = void
+>
+auto makeBoxedView(
+    Iterator first, Iterator last,
+    ScalarValue&& defaultValue, const BoundsContainer& viewBounds,
+    Executor& executor,
+    std::vector<BoundsStatistics>* statistics = nullptr
+)
+    -> BoxedView<
+        ScalarPolicy, Iterator,
+        DimensionalityRange<ScalarPolicy, Iterator>::value
+       >
+{
+    using std::begin;
+    return makeBoxedViewFrom<ScalarPolicy>(
+        first, last, std::forward<ScalarValue>(defaultValue),
+        begin(viewBounds), end(viewBounds), &executor, statistics
+    );
+}
 
-    return BoxedView<ScalarPolicy, Iterator, dimensionality(first, last)>
-        (first, last, std::forward<ScalarValue>(defaultValue), begin(viewBounds));
+// The same, with a initializer list
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Iterator = void,
+    typename ScalarValue = void
+>
+auto makeBoxedView(
+    Iterator first, Iterator last,
+    ScalarValue&& defaultValue, std::initializer_list<size_t> viewBounds,
+    Executor& executor,
+    std::vector<BoundsStatistics>* statistics = nullptr
+)
+    -> BoxedView<
+        ScalarPolicy, Iterator,
+        DimensionalityRange<ScalarPolicy, Iterator>::value
+       >
+{
+    return makeBoxedViewFrom<ScalarPolicy>(
+        first, last, std::forward<ScalarValue>(defaultValue),
+        viewBounds.begin(), viewBounds.end(), &executor, statistics
+    );
 }
 
 /** \brief Factory method to build a BoxedView of a container
@@ -1411,6 +2739,7 @@ auto makeBoxedView(
  * \ingroup user_functions
  * \param ScalarPolicy (trait template)
  * \param container the container on which the View will be based
+ * \param defaultValue, viewBounds, statistics see the range-based version
  */
 template <
     template<typename> class ScalarPolicy = NoCustomScalars,
@@ -1420,16 +2749,17 @@ template <
 >
 auto makeBoxedView(
     Container& container, ScalarValue&& defaultValue,
-    const BoundsContainer& viewBounds
+    const BoundsContainer& viewBounds,
+    std::vector<BoundsStatistics>* statistics = nullptr
 )
     -> BoxedView<
             ScalarPolicy, decltype(begin(container)),
             Dimensionality<ScalarPolicy, Container>::value
        >
 {
-    return makeBoxedView(
+    return makeBoxedView<ScalarPolicy>(
         begin(container), end(container),
-        std::forward<ScalarValue>(defaultValue), viewBounds
+        std::forward<ScalarValue>(defaultValue), viewBounds, statistics
     );
 }
 
@@ -1441,40 +2771,88 @@ template <
 >
 auto makeBoxedView(
     Container& container, ScalarValue&& defaultValue,
-    std::initializer_list<size_t> viewBounds
+    std::initializer_list<size_t> viewBounds,
+    std::vector<BoundsStatistics>* statistics = nullptr
 )
     -> BoxedView<
         ScalarPolicy, decltype(begin(container)),
         Dimensionality<ScalarPolicy, Container>::value
        >
 {
-    return makeBoxedView(
+    return makeBoxedView<ScalarPolicy>(
         begin(container), end(container),
-        std::forward<ScalarValue>(defaultValue), viewBounds
+        std::forward<ScalarValue>(defaultValue), viewBounds, statistics
     );
 }
 
-//***************************************************************************
-// BoxedViewScalarProxy
-//***************************************************************************
-/** \brief Proxy class representing a reference to a (possibly defaulted)
- *  scalar value. Plays the same role as vector<bool>::reference
- *  \ingroup boxed_view
+/** \brief The same, computing the bounds of the container (if they are
+ * needed) in parallel on `executor`, see `parallelBounds`
  */
-template <typename RawIterator, bool isConstProxy>
-class BoxedViewScalarProxy {
-    using RawScalarType = typename std::iterator_traits<RawIterator>::value_type;
-    using ConstScalarType = typename std::add_const<RawScalarType>::type;
-    using ScalarType = typename std::conditional<
-        isConstProxy, ConstScalarType, RawScalarType
-    >::type;
-
-public:
-    BoxedViewScalarProxy(
-        RawIterator target, ScalarType const* defaultValue, bool valid
-    ) :
-        target_{target},
-        defaultValue_{defaultValue},
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename ScalarValue = void,
+    typename BoundsContainer = void
+>
+auto makeBoxedView(
+    Container& container, ScalarValue&& defaultValue,
+    const BoundsContainer& viewBounds, Executor& executor,
+    std::vector<BoundsStatistics>* statistics = nullptr
+)
+    -> BoxedView<
+            ScalarPolicy, decltype(begin(container)),
+            Dimensionality<ScalarPolicy, Container>::value
+       >
+{
+    return makeBoxedView<ScalarPolicy>(
+        begin(container), end(container),
+        std::forward<ScalarValue>(defaultValue), viewBounds, executor, statistics
+    );
+}
+
+// The same, with a initializer list
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename ScalarValue = void
+>
+auto makeBoxedView(
+    Container& container, ScalarValue&& defaultValue,
+    std::initializer_list<size_t> viewBounds, Executor& executor,
+    std::vector<BoundsStatistics>* statistics = nullptr
+)
+    -> BoxedView<
+        ScalarPolicy, decltype(begin(container)),
+        Dimensionality<ScalarPolicy, Container>::value
+       >
+{
+    return makeBoxedView<ScalarPolicy>(
+        begin(container), end(container),
+        std::forward<ScalarValue>(defaultValue), viewBounds, executor, statistics
+    );
+}
+
+//***************************************************************************
+// BoxedViewScalarProxy
+//***************************************************************************
+/** \brief Proxy class representing a reference to a (possibly defaulted)
+ *  scalar value. Plays the same role as vector<bool>::reference
+ *  \ingroup boxed_view
+ */
+template <typename RawIterator, bool isConstProxy>
+class BoxedViewScalarProxy {
+    using RawScalarType = typename std::iterator_traits<RawIterator>::value_type;
+    using ConstScalarType = typename std::add_const<RawScalarType>::type;
+    using ScalarType = typename std::conditional<
+        isConstProxy, ConstScalarType, RawScalarType
+    >::type;
+
+public:
+    BoxedViewScalarProxy(
+        RawIterator target, ScalarType const* defaultValue, bool valid
+    ) :
+        target_{target},
+        defaultValue_{defaultValue},
         valid_{valid} {}
 
     BoxedViewScalarProxy& operator=(const ScalarType& rhs) {
@@ -1941,5 +3319,5937 @@ auto operator+(
 
 } // namespace - BoxedView
 
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @ZipView
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+// **************************************************************************
+// forward declaration of ZipViewIterator
+/** \brief The iterator used in ZipView. It steps the raw iterators of all
+ * the zipped ranges together, so that empty subranges are skipped
+ * only once for all of them.
+ *  \ingroup zip_view
+ */
+template <
+    template<typename> class ScalarPolicy,
+    bool hasSubIterator,
+    typename... RawIterators
+> class ZipViewIterator;
+
+//***************************************************************************
+// Helper traits
+//***************************************************************************
+/** \brief Provides the member constant `value`, which is
+ * `true` if the first of `RawIterators` points to a subcontainer,
+ * `false` otherwise
+ * \ingroup detail
+ */
+template <
+    template<typename> class ScalarPolicy,
+    typename FirstRawIterator,
+    typename... RawIterators
+>
+struct ZipHasSubIterator {
+    static constexpr bool value = !IsScalar<
+        ScalarPolicy, typename std::iterator_traits<FirstRawIterator>::value_type
+    >::value;
+};
+
+/** \brief The type of the iterators of the subcontainers pointed by `RawIterator`
+ * \ingroup detail
+ */
+template <typename RawIterator>
+using ChildRawIteratorType = typename IteratorType<
+    typename std::iterator_traits<RawIterator>::reference
+>::type;
+
+/** \brief The ZipViewIterator on the ranges pointed by `RawIterators`
+ * \ingroup detail
+ */
+template <template<typename> class ScalarPolicy, typename... RawIterators>
+using ZipViewIteratorType = ZipViewIterator<
+    ScalarPolicy,
+    ZipHasSubIterator<ScalarPolicy, RawIterators...>::value,
+    RawIterators...
+>;
+
+/** \brief Provides the member constant `value`, which is
+ * `true` if all the `values` are equal
+ * \ingroup detail
+ */
+template <size_t... values>
+struct AllEqual {
+    static constexpr bool value = true;
+};
+
+template <size_t value1, size_t value2, size_t... values>
+struct AllEqual<value1, value2, values...> {
+    static constexpr bool value =
+        (value1 == value2) && AllEqual<value2, values...>::value;
+};
+
+//***************************************************************************
+// ZipShape
+//***************************************************************************
+/** \brief Provides the static member function `match`, which checks
+ * if a set of ranges have the same shape, i.e. if they hold the same number
+ * of elements and, recursively, if their subranges have the same shape
+ * \ingroup detail
+ */
+template <
+    template<typename> class ScalarPolicy,
+    bool hasSubRange,
+    typename... RawIterators
+>
+struct ZipShape;
+
+// Specialization for ranges of scalars: only the sizes must match
+template <template<typename> class ScalarPolicy, typename... RawIterators>
+struct ZipShape<ScalarPolicy, false, RawIterators...> {
+    using RawIteratorTuple = std::tuple<RawIterators...>;
+
+    static bool match(const RawIteratorTuple& firsts, const RawIteratorTuple& lasts) {
+        return match(
+            firsts, lasts,
+            typename MakeIndexSequence<sizeof...(RawIterators)>::type{}
+        );
+    }
+
+    template <size_t... indices>
+    static bool match(
+        const RawIteratorTuple& firsts, const RawIteratorTuple& lasts,
+        IndexSequence<indices...>
+    ) {
+        const size_t sizes[] = {
+            static_cast<size_t>(std::distance(
+                std::get<indices>(firsts), std::get<indices>(lasts)
+            ))...
+        };
+        for (auto size : sizes) {
+            if (size != sizes[0]) return false;
+        }
+        return true;
+    }
+};
+
+// Specialization for ranges of subranges: walk them together
+// and compare the subranges
+template <template<typename> class ScalarPolicy, typename... RawIterators>
+struct ZipShape<ScalarPolicy, true, RawIterators...> {
+    using RawIteratorTuple = std::tuple<RawIterators...>;
+    using ChildShape = ZipShape<
+        ScalarPolicy,
+        ZipHasSubIterator<ScalarPolicy, ChildRawIteratorType<RawIterators>...>::value,
+        ChildRawIteratorType<RawIterators>...
+    >;
+
+    static bool match(const RawIteratorTuple& firsts, const RawIteratorTuple& lasts) {
+        return match(
+            firsts, lasts,
+            typename MakeIndexSequence<sizeof...(RawIterators)>::type{}
+        );
+    }
+
+    template <size_t... indices>
+    static bool match(
+        RawIteratorTuple currents, const RawIteratorTuple& lasts,
+        IndexSequence<indices...>
+    ) {
+        while (1) {
+            const bool atEnd[] = {
+                (std::get<indices>(currents) == std::get<indices>(lasts))...
+            };
+            // All the ranges must end at the same time
+            for (auto flag : atEnd) {
+                if (flag != atEnd[0]) return false;
+            }
+            if (atEnd[0]) return true;
+
+            if (!ChildShape::match(
+                std::tuple<ChildRawIteratorType<RawIterators>...>(
+                    begin(*std::get<indices>(currents))...
+                ),
+                std::tuple<ChildRawIteratorType<RawIterators>...>(
+                    end(*std::get<indices>(currents))...
+                )
+            )) {
+                return false;
+            }
+
+            (void)Swallow{0, (++std::get<indices>(currents), 0)...};
+        }
+    }
+};
+
+//***************************************************************************
+// ZipView
+//***************************************************************************
+/** \brief A class which makes a set of equally-shaped ranges appear
+ * as a linear array of tuples, each tuple holding references to
+ * the scalar elements found at the same position in all the ranges.
+ * The shapes are checked once at construction, afterwards the raw
+ * iterators of all the ranges are moved together, row by row.
+ * \param ScalarPolicy (trait template)
+ * \ingroup zip_view
+ */
+template <template<typename> class ScalarPolicy, typename... RawIterators>
+class ZipView {
+    static_assert(sizeof...(RawIterators) > 0, "ZipView: no range to zip");
+    static_assert(
+        AllEqual<DimensionalityRange<ScalarPolicy, RawIterators>::value...>::value,
+        "ZipView: the zipped ranges have different dimensionality"
+    );
+
+public:
+    using iterator = ZipViewIteratorType<ScalarPolicy, RawIterators...>;
+    using const_iterator = iterator;
+        // constness is determined by the raw iterators
+    using value_type = typename iterator::value_type;
+    using reference = typename iterator::reference;
+    using const_reference = reference;
+    using difference_type = typename iterator::difference_type;
+    using size_type = size_t;
+
+    using RawIteratorTuple = std::tuple<RawIterators...>;
+
+    ZipView() {}
+    ZipView(RawIteratorTuple firsts, RawIteratorTuple lasts) :
+        begin_{std::move(firsts)}, end_{std::move(lasts)}
+    {
+        if (!ZipShape<
+                ScalarPolicy,
+                ZipHasSubIterator<ScalarPolicy, RawIterators...>::value,
+                RawIterators...
+            >::match(begin_, end_)
+        ) {
+            throw std::runtime_error("ZipView : the zipped ranges have different shapes");
+        }
+    }
+    ZipView(const ZipView& other) = default;  /**< \note It performs a shallow copy! */
+    ~ZipView() = default;
+    ZipView& operator=(const ZipView& other) = default; /**< \note It performs a shallow copy! */
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    iterator begin() const {return iterator::makeBegin(begin_, end_);}
+    const_iterator cbegin() const {return iterator::makeBegin(begin_, end_);}
+    iterator end() const {return iterator::makeEnd(begin_, end_);}
+    const_iterator cend() const {return iterator::makeEnd(begin_, end_);}
+
+    size_type size() const {
+        if (cachedSize_ == NO_VALUE) {
+            cachedSize_ = std::distance(begin(), end());
+        }
+        return cachedSize_;
+    }
+    size_type max_size() const {return std::numeric_limits<size_type>::max();};
+    bool empty() const {return (begin() == end());}
+
+private:
+    RawIteratorTuple begin_;
+    RawIteratorTuple end_;
+    mutable size_t cachedSize_ = NO_VALUE;
+};
+
+//***************************************************************************
+// zip
+//***************************************************************************
+/** \brief Factory method to build a ZipView of some FlatViews.
+ * Throws `std::runtime_error` if the underlying ranges have different shapes,
+ * or if any of the views is a part built by `FlatView::split`
+ * (a ZipView always covers whole ranges).
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template, deduced from the views)
+ * \param views the FlatViews to be zipped
+ */
+template <template<typename> class ScalarPolicy, typename... RawIterators>
+auto zip(const FlatView<ScalarPolicy, RawIterators>&... views)
+    -> ZipView<ScalarPolicy, RawIterators...>
+{
+    const bool isPart[] = {views.isPart()...};
+    for (auto flag : isPart) {
+        if (flag) throw std::runtime_error("zip : cannot zip the parts of a split FlatView");
+    }
+    return ZipView<ScalarPolicy, RawIterators...>{
+        std::tuple<RawIterators...>(views.rawBegin()...),
+        std::tuple<RawIterators...>(views.rawEnd()...)
+    };
+}
+
+//***************************************************************************
+// ZipViewIterator
+//***************************************************************************
+// Specialization for RawIterators pointing to subcontainers.
+// Since the shapes have been checked by ZipView, only the first range
+// is tested to detect the end of a row: the other raw iterators
+// just follow it.
+template <template<typename> class ScalarPolicy, typename... RawIterators>
+class ZipViewIterator<ScalarPolicy, true, RawIterators...>
+{
+public:
+    using RawIteratorTuple = std::tuple<RawIterators...>;
+
+    // [iterator.traits]
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::tuple<
+        typename IteratorScalarType<ScalarPolicy, RawIterators>::type...
+    >;
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = std::tuple<
+        typename IteratorScalarType<ScalarPolicy, RawIterators>::reference...
+    >;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    ZipViewIterator() : child_{}, current_{}, end_{} {}
+    /* \brief Default constructor. */
+
+    ZipViewIterator(const ZipViewIterator&) = default;
+
+    static ZipViewIterator makeBegin(const RawIteratorTuple& firsts, const RawIteratorTuple& lasts) {
+        return ZipViewIterator{firsts, lasts, Forward{}};
+    }
+    static ZipViewIterator makeEnd(const RawIteratorTuple& firsts, const RawIteratorTuple& lasts) {
+        return ZipViewIterator{firsts, lasts, Backward{}};
+    }
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    // [iterator.iterators]
+    reference operator*() const {return dereference();}
+    ZipViewIterator& operator++() {increment(); return *this;}
+
+    // [input.iterators] and [output.iterators]
+    bool operator==(const ZipViewIterator& other) const {return equal(other);}
+    bool operator!=(const ZipViewIterator& other) const {return !((*this) == other);}
+    ZipViewIterator operator++(int) {auto tmp = *this; ++(*this); return tmp;}
+
+    // **************************************************************************
+
+    bool valid() const {
+        return (std::get<0>(current_) != std::get<0>(end_)) && (child_.valid());
+    }
+
+private: // funcs
+    using Indices = typename MakeIndexSequence<sizeof...(RawIterators)>::type;
+    using ChildIterator = ZipViewIteratorType<
+        ScalarPolicy, ChildRawIteratorType<RawIterators>...
+    >;
+
+    ZipViewIterator(const RawIteratorTuple& firsts, const RawIteratorTuple& lasts, Forward)
+        : current_{firsts}
+        , end_{lasts}
+    {
+        increment();
+    }
+    ZipViewIterator(const RawIteratorTuple&, const RawIteratorTuple& lasts, Backward)
+        : current_{lasts}
+        , end_{lasts}
+    {
+    }
+
+    void increment() {
+        if (valid()) {
+            // child_ is already in a valid state,
+            // move it forward
+            ++child_;
+            if (child_.valid()) return;
+
+            // no more scalar elements in the current rows,
+            // move all the ranges forward
+            nextRow(Indices{});
+        }
+
+        while(1) {
+            // just updated current_, try to build
+            // a valid subiterator at this location
+            if (std::get<0>(current_) == std::get<0>(end_)) return;
+            child_ = makeChild(Indices{});
+            if (child_.valid()) return;
+            nextRow(Indices{});
+        }
+    }
+
+    template <size_t... indices>
+    void nextRow(IndexSequence<indices...>) {
+        (void)Swallow{0, (++std::get<indices>(current_), 0)...};
+    }
+
+    template <size_t... indices>
+    ChildIterator makeChild(IndexSequence<indices...>) const {
+        return ChildIterator::makeBegin(
+            typename ChildIterator::RawIteratorTuple(begin(*std::get<indices>(current_))...),
+            typename ChildIterator::RawIteratorTuple(end(*std::get<indices>(current_))...)
+        );
+    }
+
+    reference dereference() const {
+        if (!valid()) throw std::runtime_error("ZipViewIterator: access out of bounds");
+        return *child_;
+    }
+
+    bool equal(const ZipViewIterator& other) const {
+        return (std::get<0>(current_) == std::get<0>(other.current_))
+            && (std::get<0>(end_) == std::get<0>(other.end_))
+            && (
+                     (!valid() && !other.valid())
+                  || (valid()  &&  other.valid() && child_ == other.child_)
+                );
+    }
+
+private: // members
+    ChildIterator child_;
+    RawIteratorTuple current_;
+    RawIteratorTuple end_;
+};
+
+// **************************************************************************
+// Specialization for RawIterators pointing to scalars
+template <template<typename> class ScalarPolicy, typename... RawIterators>
+class ZipViewIterator<ScalarPolicy, false, RawIterators...>
+{
+public:
+    using RawIteratorTuple = std::tuple<RawIterators...>;
+
+    // [iterator.traits]
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::tuple<
+        typename IteratorScalarType<ScalarPolicy, RawIterators>::type...
+    >;
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = std::tuple<
+        typename IteratorScalarType<ScalarPolicy, RawIterators>::reference...
+    >;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    ZipViewIterator() : current_{}, end_{} {}
+    /* \brief Default constructor. */
+
+    ZipViewIterator(const ZipViewIterator&) = default;
+
+    static ZipViewIterator makeBegin(const RawIteratorTuple& firsts, const RawIteratorTuple& lasts) {
+        return ZipViewIterator{firsts, lasts};
+    }
+    static ZipViewIterator makeEnd(const RawIteratorTuple& firsts, const RawIteratorTuple& lasts) {
+        return ZipViewIterator{lasts, lasts};
+    }
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    // [iterator.iterators]
+    reference operator*() const {return dereference(Indices{});}
+    ZipViewIterator& operator++() {increment(Indices{}); return *this;}
+
+    // [input.iterators] and [output.iterators]
+    bool operator==(const ZipViewIterator& other) const {
+        return (std::get<0>(current_) == std::get<0>(other.current_))
+            && (std::get<0>(end_) == std::get<0>(other.end_));
+    }
+    bool operator!=(const ZipViewIterator& other) const {return !((*this) == other);}
+    ZipViewIterator operator++(int) {auto tmp = *this; ++(*this); return tmp;}
+
+    // **************************************************************************
+
+    bool valid() const {return std::get<0>(current_) != std::get<0>(end_);}
+
+private: // funcs
+    using Indices = typename MakeIndexSequence<sizeof...(RawIterators)>::type;
+
+    ZipViewIterator(const RawIteratorTuple& currents, const RawIteratorTuple& lasts)
+        : current_{currents}
+        , end_{lasts}
+    {
+    }
+
+    template <size_t... indices>
+    void increment(IndexSequence<indices...>) {
+        if (!valid()) return;
+        (void)Swallow{0, (++std::get<indices>(current_), 0)...};
+    }
+
+    template <size_t... indices>
+    reference dereference(IndexSequence<indices...>) const {
+        if (!valid()) throw std::runtime_error("ZipViewIterator: access out of bounds");
+        return reference(*std::get<indices>(current_)...);
+        // Being the iterator at the bottom, it will return the values,
+        // instead of delegating to the subordinate
+    }
+
+private: // members
+    RawIteratorTuple current_;
+    RawIteratorTuple end_;
+};
+
+} // namespace multidim - ZipView
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @IndirectView
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// IndirectIterator
+//***************************************************************************
+/** \brief An iterator which visits the elements of a random-access range
+ * in the order given by an array of indices, i.e. `*it` is
+ * `base[indices[k]]`. Used to reorder or subset the outermost dimension
+ * of a container without copying it.
+ * \param RawIterator a random access iterator
+ * \ingroup indirect_view
+ */
+template <typename RawIterator>
+class IndirectIterator {
+    static_assert(
+        std::is_same<
+            typename std::iterator_traits<RawIterator>::iterator_category,
+            std::random_access_iterator_tag
+        >::value,
+        "IndirectIterator: the underlying iterator must be random access"
+    );
+
+public:
+    // [iterator.traits]
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename std::iterator_traits<RawIterator>::value_type;
+    using difference_type = ptrdiff_t;
+    using pointer = typename std::iterator_traits<RawIterator>::pointer;
+    using reference = typename std::iterator_traits<RawIterator>::reference;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    IndirectIterator() : base_{}, index_{nullptr} {}
+    /* \brief Default constructor. */
+
+    /** \param base the beginning of the underlying range
+     * \param index pointer to the current element of the array of indices
+     */
+    IndirectIterator(RawIterator base, size_t const* index) :
+        base_{base}, index_{index} {}
+
+    IndirectIterator(const IndirectIterator&) = default;
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    // [iterator.iterators]
+    reference operator*() const {return *(base_ + *index_);}
+    IndirectIterator& operator++() {++index_; return *this;}
+
+    // [input.iterators] and [output.iterators]
+    bool operator==(const IndirectIterator& other) const {return index_ == other.index_;}
+    bool operator!=(const IndirectIterator& other) const {return !((*this) == other);}
+    pointer operator->() const {return &(**this);}
+    IndirectIterator operator++(int) {auto tmp = *this; ++(*this); return tmp;}
+
+    // [bidirectional.iterators]
+    IndirectIterator& operator--() {--index_; return *this;}
+    IndirectIterator operator--(int) {auto other = *this; --(*this); return other;}
+
+    // [random.access.iterators]
+    IndirectIterator& operator+=(difference_type n) {index_ += n; return *this;}
+    IndirectIterator operator+(difference_type n) const {auto result = (*this); result += n; return result;}
+    friend IndirectIterator operator+(difference_type n, const IndirectIterator& other) {return other + n;}
+    IndirectIterator& operator-=(difference_type n) {return (*this += (-n));}
+    IndirectIterator operator-(difference_type n) const {return (*this + (-n));}
+
+    difference_type operator-(const IndirectIterator& other) const {return index_ - other.index_;}
+    bool operator<(const IndirectIterator& other) const {return index_ < other.index_;}
+    bool operator>(const IndirectIterator& other) const {return index_ > other.index_;}
+    bool operator>=(const IndirectIterator& other) const {return !((*this) < other);}
+    bool operator<=(const IndirectIterator& other) const {return !((*this) > other);}
+
+    reference operator[](difference_type n) const {return *(*this + n);}
+
+    // **************************************************************************
+
+    /** \brief The position of the current element in the underlying range */
+    size_t baseIndex() const {return *index_;}
+
+private: // members
+    RawIterator base_;
+    size_t const* index_;
+};
+
+//***************************************************************************
+// IndirectView
+//***************************************************************************
+/** \brief A range showing the elements of a random-access range
+ * in the order given by an array of indices, e.g. to reorder or subset
+ * the rows of a container without copying them.
+ * Being a range, it can be passed to all the functions of the library
+ * (`bounds`, `makeFlatView`, `makeBoxedView`...).
+ * \note Neither the underlying range nor the indices are copied:
+ *  both must outlive the View (and the Views built on it)
+ * \ingroup indirect_view
+ */
+template <typename RawIterator>
+class IndirectView {
+public:
+    using iterator = IndirectIterator<RawIterator>;
+    using const_iterator = iterator;
+        // constness is determined by the raw iterator
+    using value_type = typename iterator::value_type;
+    using reference = typename iterator::reference;
+    using const_reference = reference;
+    using difference_type = typename iterator::difference_type;
+    using size_type = size_t;
+
+    IndirectView() : base_{}, indicesBegin_{nullptr}, indicesEnd_{nullptr} {}
+    IndirectView(RawIterator base, size_t const* indicesFirst, size_t const* indicesLast) :
+        base_{base}, indicesBegin_{indicesFirst}, indicesEnd_{indicesLast} {}
+    IndirectView(const IndirectView& other) = default;  /**< \note It performs a shallow copy! */
+    IndirectView& operator=(const IndirectView& other) = default; /**< \note It performs a shallow copy! */
+
+    iterator begin() const {return iterator{base_, indicesBegin_};}
+    const_iterator cbegin() const {return begin();}
+    iterator end() const {return iterator{base_, indicesEnd_};}
+    const_iterator cend() const {return end();}
+
+    reference front() const {return *begin();}
+    reference back() const {return *(end() - 1);}
+    reference operator[](size_type n) const {return begin()[n];}
+
+    size_type size() const {return static_cast<size_type>(indicesEnd_ - indicesBegin_);}
+    bool empty() const {return (size() == 0);}
+
+private:
+    RawIterator base_;
+    size_t const* indicesBegin_;
+    size_t const* indicesEnd_;
+};
+
+//***************************************************************************
+// makeIndirectView
+//***************************************************************************
+/** \brief Factory method to build an IndirectView of a container.
+ * Throws `std::runtime_error` if an index is out of the container bounds.
+ * \ingroup user_functions
+ * \param container a container with random access iterators
+ * \param indices the positions of the elements of `container`
+ *  to be shown by the View, in the order in which they will be shown
+ *  (it is not copied, so it must outlive the View: temporaries
+ *  are rejected at compile time)
+ */
+template <typename Container>
+auto makeIndirectView(Container& container, const std::vector<size_t>& indices)
+    -> IndirectView<decltype(begin(container))>
+{
+    const size_t containerSize = size(container);
+    for (auto index : indices) {
+        if (index >= containerSize) {
+            throw std::runtime_error("makeIndirectView : index out of bounds");
+        }
+    }
+    return IndirectView<decltype(begin(container))>{
+        begin(container), indices.data(), indices.data() + indices.size()
+    };
+}
+
+// The View keeps a pointer to the indices, so temporaries are rejected
+template <typename Container>
+void makeIndirectView(Container& container, std::vector<size_t>&& indices) = delete;
+
+/** \brief Factory method to build a FlatView of a container,
+ *  whose outermost dimension is reordered by an array of indices,
+ *  see makeIndirectView
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ */
+template <template<typename> class ScalarPolicy = NoCustomScalars, typename Container = void>
+auto makeIndirectFlatView(Container& container, const std::vector<size_t>& indices)
+    -> FlatView<ScalarPolicy, IndirectIterator<decltype(begin(container))>>
+{
+    auto indirectView = makeIndirectView(container, indices);
+    return makeFlatView<ScalarPolicy>(indirectView.begin(), indirectView.end());
+}
+template <template<typename> class ScalarPolicy = NoCustomScalars, typename Container = void>
+void makeIndirectFlatView(Container& container, std::vector<size_t>&& indices) = delete;
+
+/** \brief Factory method to build a BoxedView of a container,
+ *  whose outermost dimension is reordered by an array of indices,
+ *  see makeIndirectView and makeBoxedView
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename ScalarValue = void,
+    typename BoundsContainer = void
+>
+auto makeIndirectBoxedView(
+    Container& container, const std::vector<size_t>& indices,
+    ScalarValue&& defaultValue, const BoundsContainer& viewBounds
+)
+    -> BoxedView<
+        ScalarPolicy, IndirectIterator<decltype(begin(container))>,
+        Dimensionality<ScalarPolicy, Container>::value
+       >
+{
+    auto indirectView = makeIndirectView(container, indices);
+    return makeBoxedView<ScalarPolicy>(
+        indirectView.begin(), indirectView.end(),
+        std::forward<ScalarValue>(defaultValue), viewBounds
+    );
+}
+
+// The same, with a initializer list
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename ScalarValue = void
+>
+auto makeIndirectBoxedView(
+    Container& container, const std::vector<size_t>& indices,
+    ScalarValue&& defaultValue, std::initializer_list<size_t> viewBounds
+)
+    -> BoxedView<
+        ScalarPolicy, IndirectIterator<decltype(begin(container))>,
+        Dimensionality<ScalarPolicy, Container>::value
+       >
+{
+    auto indirectView = makeIndirectView(container, indices);
+    return makeBoxedView<ScalarPolicy>(
+        indirectView.begin(), indirectView.end(),
+        std::forward<ScalarValue>(defaultValue), viewBounds
+    );
+}
+
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename ScalarValue = void,
+    typename BoundsContainer = void
+>
+void makeIndirectBoxedView(
+    Container& container, std::vector<size_t>&& indices,
+    ScalarValue&& defaultValue, const BoundsContainer& viewBounds
+) = delete;
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename ScalarValue = void
+>
+void makeIndirectBoxedView(
+    Container& container, std::vector<size_t>&& indices,
+    ScalarValue&& defaultValue, std::initializer_list<size_t> viewBounds
+) = delete;
+
+} // namespace multidim - IndirectView
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @LengthBuckets
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// LengthBuckets
+//***************************************************************************
+/** \brief The result of `bucketByLength`: a set of BoxedViews, each one
+ * showing the elements of the outermost dimension of a container
+ * (the "rows") whose length falls in a bucket, and padding them
+ * only up to the bounds of the bucket.
+ * The Views refer to index arrays owned by this class, so it can be
+ * moved, but not copied.
+ * \param ScalarPolicy (trait template)
+ * \ingroup boxed_view
+ */
+template <
+    template<typename> class ScalarPolicy,
+    typename RawIterator,
+    size_t dimensionality_
+>
+class LengthBuckets {
+    static_assert(dimensionality_ > 1, "LengthBuckets: the rows must be containers");
+
+public:
+    using View = BoxedView<ScalarPolicy, IndirectIterator<RawIterator>, dimensionality_>;
+    using ScalarType = typename View::ScalarType;
+    using iterator = typename std::vector<View>::iterator;
+    using const_iterator = typename std::vector<View>::const_iterator;
+    using size_type = size_t;
+
+    /** \param first, last the range of the rows
+     * \param bucketEdges sorted list of maximum lengths: bucket `b` holds
+     *  the rows longer than `bucketEdges[b-1]` and not longer than
+     *  `bucketEdges[b]`. An additional last bucket holds the rows longer
+     *  than all the edges.
+     * \param defaultValue the value used to pad the rows
+     */
+    LengthBuckets(
+        RawIterator first, RawIterator last,
+        const std::vector<size_t>& bucketEdges,
+        ScalarType defaultValue
+    ) :
+        indices_(bucketEdges.size() + 1)
+    {
+        if (!std::is_sorted(bucketEdges.begin(), bucketEdges.end())) {
+            throw std::runtime_error("bucketByLength : bucket edges are not sorted");
+        }
+
+        locations_.reserve(static_cast<size_t>(std::distance(first, last)));
+        size_t row = 0;
+        for (auto it = first; it != last; ++it, ++row) {
+            const size_t bucket = static_cast<size_t>(
+                std::lower_bound(bucketEdges.begin(), bucketEdges.end(), multidim::size(*it))
+                - bucketEdges.begin()
+            );
+            locations_.emplace_back(bucket, indices_[bucket].size());
+            indices_[bucket].push_back(row);
+        }
+
+        views_.reserve(indices_.size());
+        for (const auto& bucketIndices : indices_) {
+            views_.push_back(makeBoxedView<ScalarPolicy>(
+                IndirectIterator<RawIterator>{first, bucketIndices.data()},
+                IndirectIterator<RawIterator>{first, bucketIndices.data() + bucketIndices.size()},
+                defaultValue, {}
+            ));
+        }
+    }
+    LengthBuckets(const LengthBuckets&) = delete;
+    LengthBuckets(LengthBuckets&&) = default;
+        // moving the index arrays does not relocate their elements,
+        // so the Views stay valid
+    LengthBuckets& operator=(const LengthBuckets&) = delete;
+    LengthBuckets& operator=(LengthBuckets&&) = default;
+
+    // **************************************************************************
+    // Access to the buckets
+    // **************************************************************************
+    iterator begin() {return views_.begin();}
+    const_iterator begin() const {return views_.begin();}
+    iterator end() {return views_.end();}
+    const_iterator end() const {return views_.end();}
+
+    View& operator[](size_type bucket) {return views_[bucket];}
+    const View& operator[](size_type bucket) const {return views_[bucket];}
+
+    /** \brief Number of buckets */
+    size_type size() const {return views_.size();}
+
+    // **************************************************************************
+    // Permutation
+    // **************************************************************************
+    /** \brief The positions in the original range of the rows of a bucket,
+     * i.e. `(*this)[bucket][k]` shows the row `indices(bucket)[k]`
+     */
+    const std::vector<size_t>& indices(size_type bucket) const {return indices_[bucket];}
+
+    /** \brief Inverse of `indices`: the bucket and the position in the bucket
+     * of the row `row` of the original range
+     */
+    std::pair<size_t, size_t> location(size_type row) const {return locations_[row];}
+
+private:
+    std::vector<std::vector<size_t>> indices_;
+    std::vector<std::pair<size_t, size_t>> locations_;
+    std::vector<View> views_;
+};
+
+//***************************************************************************
+// bucketByLength
+//***************************************************************************
+/** \brief Groups the rows of a container (the elements of its outermost
+ * dimension) by their length, and returns a BoxedView for each group,
+ * padded only up to the bounds of its own rows. This spares the padding
+ * of all the rows to the length of the longest one.
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ * \param container a container of containers, having random access iterators
+ * \param bucketEdges sorted list of maximum row lengths, see LengthBuckets
+ * \param defaultValue (optional) the value used to pad the rows
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void
+>
+auto bucketByLength(
+    Container& container,
+    const std::vector<size_t>& bucketEdges,
+    typename IteratorScalarType<ScalarPolicy, decltype(begin(container))>::type defaultValue = {}
+)
+    -> LengthBuckets<
+        ScalarPolicy, decltype(begin(container)),
+        Dimensionality<ScalarPolicy, Container>::value
+       >
+{
+    return LengthBuckets<
+        ScalarPolicy, decltype(begin(container)),
+        Dimensionality<ScalarPolicy, Container>::value
+    >{begin(container), end(container), bucketEdges, std::move(defaultValue)};
+}
+
+} // namespace multidim - LengthBuckets
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @FilteredFlatView
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// countTrailingZeros
+//***************************************************************************
+/** \brief The index of the lowest set bit of a nonzero word
+ * \ingroup detail
+ */
+inline size_t countTrailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(word));
+#else
+    size_t result = 0;
+    while ((word & 1) == 0) {word >>= 1; ++result;}
+    return result;
+#endif
+}
+
+/** \brief The index of the highest set bit of a nonzero word
+ * \ingroup detail
+ */
+inline size_t floorLog2(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - static_cast<size_t>(__builtin_clzll(word));
+#else
+    size_t result = 0;
+    while (word >>= 1) ++result;
+    return result;
+#endif
+}
+
+//***************************************************************************
+// FilteredFlatViewIterator
+//***************************************************************************
+/** \brief The iterator used in FilteredFlatView.
+ * It walks the underlying FlatView one segment (i.e. one contiguous
+ * bottom-level subrange) at a time and calls the predicate in a plain loop
+ * on the raw iterators of the segment, so that the rejected elements
+ * cost no traversal of the upper levels.
+ * If the View holds a bitmap of the surviving positions, the predicate
+ * is not called at all: the rejected elements are jumped a word at a time.
+ * \param FlatViewIteratorType the iterator of the underlying FlatView
+ * \ingroup flat_view_adaptors
+ */
+template <typename FlatViewIteratorType, typename Predicate>
+class FilteredFlatViewIterator {
+public:
+    // [iterator.traits]
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename FlatViewIteratorType::value_type;
+    using difference_type = ptrdiff_t;
+    using pointer = typename FlatViewIteratorType::pointer;
+    using reference = typename FlatViewIteratorType::reference;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    FilteredFlatViewIterator() = default;
+    /* \brief Default constructor. */
+
+    /** \param first the beginning of the underlying FlatView
+     * \param viewSize the number of scalar elements of the underlying FlatView
+     * \param predicate the predicate which the elements must satisfy
+     * \param bitmap (optional) the surviving positions, see FilteredFlatView::cachePositions
+     */
+    static FilteredFlatViewIterator makeBegin(
+        FlatViewIteratorType first, size_t viewSize,
+        Predicate const* predicate, uint64_t const* bitmap
+    ) {
+        FilteredFlatViewIterator result;
+        result.cursor_ = first;
+        result.viewLeft_ = viewSize;
+        result.viewSize_ = viewSize;
+        result.predicate_ = predicate;
+        result.bitmap_ = bitmap;
+        if (viewSize > 0) result.enterSegment();
+        result.seek();
+        return result;
+    }
+    static FilteredFlatViewIterator makeEnd(size_t viewSize) {
+        FilteredFlatViewIterator result;
+        result.position_ = viewSize;
+        result.viewSize_ = viewSize;
+        return result;
+    }
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    // [iterator.iterators]
+    reference operator*() const {return *leaf_;}
+    FilteredFlatViewIterator& operator++() {
+        step();
+        seek();
+        return *this;
+    }
+
+    // [input.iterators] and [output.iterators]
+    bool operator==(const FilteredFlatViewIterator& other) const {return position_ == other.position_;}
+    bool operator!=(const FilteredFlatViewIterator& other) const {return !((*this) == other);}
+    pointer operator->() const {return &(**this);}
+    FilteredFlatViewIterator operator++(int) {auto tmp = *this; ++(*this); return tmp;}
+
+    // **************************************************************************
+
+    /** \brief The position of the current element in the underlying FlatView */
+    size_t position() const {return position_;}
+
+private: // funcs
+    using SegmentIterator = typename FlatViewIteratorType::SegmentIterator;
+
+    // Loads the segment under cursor_, clipped to the end of the View
+    void enterSegment() {
+        leaf_ = cursor_.segmentBegin();
+        const size_t segmentLength = static_cast<size_t>(std::distance(leaf_, cursor_.segmentEnd()));
+        segmentLeft_ = std::min(segmentLength, viewLeft_);
+        viewLeft_ -= segmentLeft_;
+    }
+
+    void step() {
+        ++leaf_;
+        ++position_;
+        --segmentLeft_;
+        if (segmentLeft_ == 0 && viewLeft_ > 0) {
+            cursor_.nextSegment();
+            enterSegment();
+        }
+    }
+
+    // Moves forward by n elements, jumping whole segments
+    void skip(size_t n) {
+        while (n >= segmentLeft_ && viewLeft_ > 0) {
+            n -= segmentLeft_;
+            position_ += segmentLeft_;
+            cursor_.nextSegment();
+            enterSegment();
+        }
+        std::advance(leaf_, n);
+        position_ += n;
+        segmentLeft_ -= n;
+    }
+
+    // Moves to the first surviving element at or after the current position
+    void seek() {
+        if (bitmap_ != nullptr) {
+            seekInBitmap();
+            return;
+        }
+        while (1) {
+            // the hot loop: only the raw iterator and the predicate
+            while (segmentLeft_ > 0) {
+                if ((*predicate_)(*leaf_)) return;
+                ++leaf_;
+                ++position_;
+                --segmentLeft_;
+            }
+            if (viewLeft_ == 0) return; // position_ == viewSize_, i.e. end()
+            cursor_.nextSegment();
+            enterSegment();
+        }
+    }
+
+    void seekInBitmap() {
+        if (position_ >= viewSize_) return;
+        size_t wordIndex = position_ / 64;
+        uint64_t word = bitmap_[wordIndex] & (~uint64_t{0} << (position_ % 64));
+        const size_t wordCount = (viewSize_ + 63) / 64;
+        while (word == 0) {
+            ++wordIndex;
+            if (wordIndex == wordCount) {
+                position_ = viewSize_;
+                return;
+            }
+            word = bitmap_[wordIndex];
+        }
+        skip(wordIndex * 64 + countTrailingZeros(word) - position_);
+    }
+
+private: // members
+    FlatViewIteratorType cursor_{};
+        // positioned on the current segment
+    SegmentIterator leaf_{};
+    size_t segmentLeft_ = 0;
+        // elements left in the current segment, including *leaf_
+    size_t viewLeft_ = 0;
+        // elements of the View after the current segment
+    size_t position_ = 0;
+    size_t viewSize_ = 0;
+    Predicate const* predicate_ = nullptr;
+    uint64_t const* bitmap_ = nullptr;
+};
+
+//***************************************************************************
+// FilteredFlatView
+//***************************************************************************
+/** \brief A View showing only the scalar elements of a FlatView which
+ * satisfy a predicate. The predicate is applied lazily, during the iteration.
+ *
+ * If the View is traversed many times, `cachePositions()` stores the
+ * surviving positions in a bitmap, and the following traversals
+ * will not call the predicate any more.
+ * \note The iterators refer to the predicate and to the bitmap
+ *  held by the View, so they must not outlive it. The bitmap is not updated
+ *  if the elements change: call `cachePositions()` again, or `clearCache()`.
+ * \ingroup flat_view_adaptors
+ */
+template <
+    template<typename> class ScalarPolicy,
+    typename RawIterator,
+    typename Predicate
+>
+class FilteredFlatView {
+public:
+    using BaseView = FlatView<ScalarPolicy, RawIterator>;
+    using iterator = FilteredFlatViewIterator<typename BaseView::iterator, Predicate>;
+    using const_iterator = FilteredFlatViewIterator<typename BaseView::const_iterator, Predicate>;
+    using value_type = typename iterator::value_type;
+    using reference = typename iterator::reference;
+    using const_reference = typename const_iterator::reference;
+    using difference_type = ptrdiff_t;
+    using size_type = size_t;
+
+    FilteredFlatView(BaseView view, Predicate predicate) :
+        view_{std::move(view)}, predicate_{std::move(predicate)} {}
+
+    iterator begin() {
+        return iterator::makeBegin(view_.begin(), view_.size(), &predicate_, bitmapData());
+    }
+    iterator end() {return iterator::makeEnd(view_.size());}
+    const_iterator begin() const {
+        return const_iterator::makeBegin(view_.cbegin(), view_.size(), &predicate_, bitmapData());
+    }
+    const_iterator end() const {return const_iterator::makeEnd(view_.size());}
+    const_iterator cbegin() const {return begin();}
+    const_iterator cend() const {return end();}
+
+    /** \brief The number of surviving elements. Unless the positions are cached,
+     * it requires a traversal of the View. */
+    size_type size() const {
+        if (bitmap_ == nullptr) return static_cast<size_type>(std::distance(begin(), end()));
+        size_type result = 0;
+        for (uint64_t word : *bitmap_) {
+            for (; word != 0; word &= word - 1) ++result;
+        }
+        return result;
+    }
+    bool empty() const {return (begin() == end());}
+
+    // **************************************************************************
+    // Position cache
+    // **************************************************************************
+    /** \brief Evaluates the predicate on all the elements, and stores
+     * the surviving positions in a bitmap (one bit per element of the
+     * underlying View) used by the following traversals.
+     */
+    void cachePositions() {
+        clearCache();
+        std::shared_ptr<std::vector<uint64_t>> bitmap = std::make_shared<std::vector<uint64_t>>(
+            (view_.size() + 63) / 64, uint64_t{0}
+        );
+        for (auto it = cbegin(); it != cend(); ++it) {
+            (*bitmap)[it.position() / 64] |= uint64_t{1} << (it.position() % 64);
+        }
+        bitmap_ = std::move(bitmap);
+    }
+    /** \brief Discards the cached positions, see cachePositions() */
+    void clearCache() {bitmap_.reset();}
+    bool hasCache() const {return (bitmap_ != nullptr);}
+
+    /** \brief The underlying FlatView */
+    const BaseView& base() const {return view_;}
+
+private:
+    uint64_t const* bitmapData() const {
+        return (bitmap_ == nullptr) ? nullptr : bitmap_->data();
+    }
+
+private:
+    BaseView view_;
+    Predicate predicate_;
+    std::shared_ptr<const std::vector<uint64_t>> bitmap_;
+        // shared, so that copies of the View do not duplicate it
+};
+
+//***************************************************************************
+// makeFilteredFlatView
+//***************************************************************************
+/** \brief Factory method to build a FilteredFlatView.
+ * \ingroup user_functions
+ * \param view the FlatView to be filtered
+ * \param predicate the condition which the shown elements must satisfy
+ * \param cachePositions if true, the surviving positions are computed
+ *  immediately and cached, see FilteredFlatView::cachePositions
+ */
+template <template<typename> class ScalarPolicy, typename RawIterator, typename Predicate>
+auto makeFilteredFlatView(
+    const FlatView<ScalarPolicy, RawIterator>& view,
+    Predicate predicate,
+    bool cachePositions = false
+) -> FilteredFlatView<ScalarPolicy, RawIterator, Predicate> {
+    FilteredFlatView<ScalarPolicy, RawIterator, Predicate> result{view, std::move(predicate)};
+    if (cachePositions) result.cachePositions();
+    return result;
+}
+
+} // namespace multidim - FilteredFlatView
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @TransformedFlatView
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// TransformedSegmentIterator
+//***************************************************************************
+/** \brief The iterator on a segment of a TransformedFlatView: it wraps the
+ * segment iterator of the underlying FlatView, applying the function at
+ * dereference. It has the category of the wrapped iterator.
+ * \ingroup detail
+ */
+template <typename BaseSegmentIterator, typename Function>
+class TransformedSegmentIterator {
+public:
+    // [iterator.traits]
+    using iterator_category = typename std::iterator_traits<BaseSegmentIterator>::iterator_category;
+    using reference = decltype(std::declval<Function const&>()(*std::declval<BaseSegmentIterator const&>()));
+    using value_type = typename std::remove_cv<typename std::remove_reference<reference>::type>::type;
+    using difference_type = typename std::iterator_traits<BaseSegmentIterator>::difference_type;
+    using pointer = value_type*;
+
+    TransformedSegmentIterator() : base_{}, function_{nullptr} {}
+    TransformedSegmentIterator(BaseSegmentIterator base, Function const* function) :
+        base_{base}, function_{function} {}
+
+    reference operator*() const {return (*function_)(*base_);}
+    TransformedSegmentIterator& operator++() {++base_; return *this;}
+    TransformedSegmentIterator operator++(int) {auto tmp = *this; ++(*this); return tmp;}
+    TransformedSegmentIterator& operator--() {--base_; return *this;}
+    TransformedSegmentIterator operator--(int) {auto tmp = *this; --(*this); return tmp;}
+    bool operator==(const TransformedSegmentIterator& other) const {return base_ == other.base_;}
+    bool operator!=(const TransformedSegmentIterator& other) const {return base_ != other.base_;}
+
+    // Only for random access base iterators
+    TransformedSegmentIterator& operator+=(difference_type n) {base_ += n; return *this;}
+    TransformedSegmentIterator operator+(difference_type n) const {auto result = (*this); result += n; return result;}
+    difference_type operator-(const TransformedSegmentIterator& other) const {return base_ - other.base_;}
+    reference operator[](difference_type n) const {return *(*this + n);}
+
+    /** \brief The segment iterator of the underlying FlatView */
+    const BaseSegmentIterator& base() const {return base_;}
+
+private:
+    BaseSegmentIterator base_;
+    Function const* function_;
+};
+
+//***************************************************************************
+// TransformedFlatViewIterator
+//***************************************************************************
+/** \brief The iterator used in TransformedFlatView. It applies the function
+ * at dereference, and delegates all the movements to the iterator of the
+ * underlying FlatView, so that its random access fast paths
+ * (jumping whole subranges using their scalarSize) are kept.
+ * \param BaseIterator the iterator of the underlying FlatView
+ * \ingroup flat_view_adaptors
+ */
+template <typename BaseIterator, typename Function>
+class TransformedFlatViewIterator {
+public:
+    // [iterator.traits]
+    using iterator_category = std::random_access_iterator_tag;
+    using reference = decltype(std::declval<Function const&>()(*std::declval<BaseIterator const&>()));
+    using value_type = typename std::remove_cv<typename std::remove_reference<reference>::type>::type;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type*;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    TransformedFlatViewIterator() : base_{}, function_{nullptr} {}
+    /* \brief Default constructor. */
+
+    /** \param base the iterator of the underlying FlatView
+     * \param function the function applied at dereference
+     */
+    TransformedFlatViewIterator(BaseIterator base, Function const* function) :
+        base_{base}, function_{function} {}
+
+    TransformedFlatViewIterator(const TransformedFlatViewIterator&) = default;
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    // [iterator.iterators]
+    reference operator*() const {return (*function_)(*base_);}
+    TransformedFlatViewIterator& operator++() {++base_; return *this;}
+
+    // [input.iterators] and [output.iterators]
+    bool operator==(const TransformedFlatViewIterator& other) const {return base_ == other.base_;}
+    bool operator!=(const TransformedFlatViewIterator& other) const {return !((*this) == other);}
+    TransformedFlatViewIterator operator++(int) {auto tmp = *this; ++(*this); return tmp;}
+
+    // [bidirectional.iterators]
+    TransformedFlatViewIterator& operator--() {--base_; return *this;}
+    TransformedFlatViewIterator operator--(int) {auto other = *this; --(*this); return other;}
+
+    // [random.access.iterators]
+    TransformedFlatViewIterator& operator+=(difference_type n) {base_ += n; return *this;}
+    TransformedFlatViewIterator operator+(difference_type n) const {auto result = (*this); result += n; return result;}
+    friend TransformedFlatViewIterator operator+(difference_type n, const TransformedFlatViewIterator& other) {return other + n;}
+    TransformedFlatViewIterator& operator-=(difference_type n) {return (*this += (-n));}
+    TransformedFlatViewIterator operator-(difference_type n) const {return (*this + (-n));}
+
+    difference_type operator-(const TransformedFlatViewIterator& other) const {return base_ - other.base_;}
+    bool operator<(const TransformedFlatViewIterator& other) const {return base_ < other.base_;}
+    bool operator>(const TransformedFlatViewIterator& other) const {return base_ > other.base_;}
+    bool operator>=(const TransformedFlatViewIterator& other) const {return !((*this) < other);}
+    bool operator<=(const TransformedFlatViewIterator& other) const {return !((*this) > other);}
+
+    reference operator[](difference_type n) const {return *(*this + n);}
+
+    // **************************************************************************
+
+    /** \brief The iterator of the underlying FlatView */
+    const BaseIterator& base() const {return base_;}
+
+    // **************************************************************************
+    // Segment access, see FlatViewIterator: the segments are those of the
+    // underlying FlatView, with the function applied at dereference
+    // **************************************************************************
+    using SegmentIterator = TransformedSegmentIterator<typename BaseIterator::SegmentIterator, Function>;
+    SegmentIterator segmentBegin() const {return SegmentIterator{base_.segmentBegin(), function_};}
+    SegmentIterator segmentEnd() const {return SegmentIterator{base_.segmentEnd(), function_};}
+    void nextSegment() {base_.nextSegment();}
+
+private: // members
+    BaseIterator base_;
+    Function const* function_;
+};
+
+//***************************************************************************
+// TransformedFlatView
+//***************************************************************************
+/** \brief A View showing the result of a function applied to each
+ * scalar element of a FlatView. The function is applied lazily,
+ * at dereference, so no temporary container is built.
+ * If the function returns a reference (e.g. MemberProjection, see
+ * FlatView::project) the elements can be modified through the View.
+ * \note The iterators refer to the function held by the View,
+ *  so they must not outlive it. The function is called as const.
+ * \ingroup flat_view_adaptors
+ */
+template <
+    template<typename> class ScalarPolicy,
+    typename RawIterator,
+    typename Function
+>
+class TransformedFlatView {
+public:
+    using BaseView = FlatView<ScalarPolicy, RawIterator>;
+    using iterator = TransformedFlatViewIterator<typename BaseView::iterator, Function>;
+    using const_iterator = TransformedFlatViewIterator<typename BaseView::const_iterator, Function>;
+    using value_type = typename iterator::value_type;
+    using reference = typename iterator::reference;
+    using const_reference = typename const_iterator::reference;
+    using difference_type = ptrdiff_t;
+    using size_type = size_t;
+
+    TransformedFlatView(BaseView view, Function function) :
+        view_{std::move(view)}, function_{std::move(function)} {}
+
+    iterator begin() {return iterator{view_.begin(), &function_};}
+    const_iterator begin() const {return const_iterator{view_.cbegin(), &function_};}
+    const_iterator cbegin() const {return begin();}
+    iterator end() {return iterator{view_.end(), &function_};}
+    const_iterator end() const {return const_iterator{view_.cend(), &function_};}
+    const_iterator cend() const {return end();}
+
+    reference operator[](size_type n) {return begin()[static_cast<difference_type>(n)];}
+    const_reference operator[](size_type n) const {return begin()[static_cast<difference_type>(n)];}
+
+    size_type size() const {return view_.size();}
+    bool empty() const {return view_.empty();}
+
+    /** \brief The underlying FlatView */
+    const BaseView& base() const {return view_;}
+
+    /** \brief Splits the View in `partCount` consecutive parts,
+     * see FlatView::split. Each part holds a copy of the function.
+     */
+    std::vector<TransformedFlatView> split(size_t partCount) const {
+        std::vector<TransformedFlatView> parts;
+        for (auto& part : view_.split(partCount)) parts.emplace_back(part, function_);
+        return parts;
+    }
+
+private:
+    BaseView view_;
+    Function function_;
+};
+
+//***************************************************************************
+// forEachSegment
+//***************************************************************************
+/** \brief Calls `function(first, count)` for each segment of the
+ * underlying FlatView, see forEachSegment: `first` applies the function
+ * of the View at dereference.
+ * \ingroup detail
+ */
+template <
+    template<typename> class ScalarPolicy,
+    typename RawIterator,
+    typename Function,
+    typename SegmentFunction
+>
+void forEachSegment(
+    const TransformedFlatView<ScalarPolicy, RawIterator, Function>& view,
+    SegmentFunction&& function
+) {
+    forEachSegment(view.begin(), view.size(), std::forward<SegmentFunction>(function));
+}
+
+//***************************************************************************
+// makeTransformedFlatView
+//***************************************************************************
+/** \brief Factory method to build a TransformedFlatView.
+ * \ingroup user_functions
+ * \param view the FlatView whose elements are to be transformed
+ * \param function the function applied to each element
+ */
+template <template<typename> class ScalarPolicy, typename RawIterator, typename Function>
+auto makeTransformedFlatView(
+    const FlatView<ScalarPolicy, RawIterator>& view,
+    Function function
+) -> TransformedFlatView<ScalarPolicy, RawIterator, Function> {
+    return TransformedFlatView<ScalarPolicy, RawIterator, Function>{view, std::move(function)};
+}
+
+} // namespace multidim - TransformedFlatView
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @Extract
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// MoveScalar
+//***************************************************************************
+/** \brief A function object casting its argument to an rvalue reference,
+ * so that it can be moved from. Temporaries are returned by value.
+ * \ingroup flat_view_adaptors
+ */
+struct MoveScalar {
+    template <typename T>
+    T&& operator()(T& value) const {return std::move(value);}
+    template <typename T>
+    T operator()(T&& value) const {return std::move(value);}
+};
+
+//***************************************************************************
+// makeMoveFlatView
+//***************************************************************************
+/** \brief Factory method to build a FlatView whose elements are
+ * returned as rvalue references, so that they are moved (and not copied)
+ * when used to build or fill other containers,
+ * e.g. `std::vector<std::string> v(mv.begin(), mv.end());`.
+ * It plays the role of `std::make_move_iterator` on a whole FlatView.
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ * \param container the container whose elements will be moved from
+ */
+template <template<typename> class ScalarPolicy = NoCustomScalars, typename Container = void>
+auto makeMoveFlatView(Container& container)
+    -> TransformedFlatView<ScalarPolicy, decltype(begin(container)), MoveScalar>
+{
+    return TransformedFlatView<ScalarPolicy, decltype(begin(container)), MoveScalar>{
+        makeFlatView<ScalarPolicy>(container), MoveScalar{}
+    };
+}
+
+//***************************************************************************
+// extract
+//***************************************************************************
+// Reserves space in the output, if it has a `reserve` member
+template <typename Output>
+auto reserveAdditional(Output& output, size_t count, int)
+    -> decltype(output.reserve(count), void())
+{
+    output.reserve(output.size() + count);
+}
+template <typename Output>
+void reserveAdditional(Output&, size_t, long) {}
+
+// Empties a subrange and frees its memory
+template <typename Range>
+void releaseRange(Range& range) {
+    using std::swap;
+    Range empty{};
+    swap(range, empty);
+}
+
+// Version for monolevel ranges: the segment is moved in bulk
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    typename Output,
+    typename std::enable_if<
+        (true == IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value),
+        long
+    >::type = 0xBEEF
+>
+void extractRange(Iterator first, Iterator last, Output& output, bool) {
+    output.insert(output.end(), std::make_move_iterator(first), std::make_move_iterator(last));
+}
+
+// Version for multilevel ranges
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    typename Output,
+    typename std::enable_if<
+        (false == IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value),
+        int
+    >::type = 0xBEEF
+>
+void extractRange(Iterator first, Iterator last, Output& output, bool releaseRows) {
+    for (auto it = first; it != last; ++it) {
+        extractRange<ScalarPolicy>(begin(*it), end(*it), output, releaseRows);
+        if (releaseRows) releaseRange(*it);
+    }
+}
+
+/** \brief Moves all the scalar elements of a nested container to the
+ * end of `output`, in the order of a FlatView, avoiding deep copies.
+ * The output is reserved in advance using `scalarSize` (if it has a
+ * `reserve` member) and each bottom-level subrange is moved in bulk.
+ * The elements of `container` are left in a moved-from state.
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ * \param container the container whose scalar elements will be moved
+ * \param output a container with `insert` (e.g. `std::vector`)
+ * \param releaseRows if true, each subcontainer is emptied and its memory
+ *  freed as soon as its elements have been moved, so that the peak memory
+ *  usage does not include both copies of the data
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename Output = void
+>
+void extract(Container& container, Output& output, bool releaseRows = false) {
+    reserveAdditional(output, scalarSize<ScalarPolicy>(container), 0);
+    extractRange<ScalarPolicy>(begin(container), end(container), output, releaseRows);
+}
+
+} // namespace multidim - Extract
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @ReshapedView
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// ReshapeLevel
+//***************************************************************************
+/** \brief One level of a ReshapedView: the prefix offsets of its subranges,
+ * i.e. the `i`-th subrange spans `[level[i], level[i + 1])` in the
+ * following level. For boxed Views, all the subranges have the same length
+ * `stride` and the offsets are computed by multiplication instead of
+ * being stored.
+ * \ingroup detail
+ */
+struct ReshapeLevel {
+    size_t const* offsets; /**< the prefix offsets, or nullptr if boxed */
+    size_t stride; /**< the length of the subranges, if boxed */
+
+    size_t operator[](size_t index) const {
+        return (offsets != nullptr) ? offsets[index] : index * stride;
+    }
+};
+
+//***************************************************************************
+// ReshapeOffsets
+//***************************************************************************
+/** \brief The levels describing a jagged or boxed structure,
+ * see ReshapedView.
+ * Not copyable, since `levels` points into `offsets`.
+ * \ingroup detail
+ */
+struct ReshapeOffsets {
+    /** \param lengths for each level except the last one, the lengths of its
+     *  subranges (i.e. the number of elements they hold in the following level)
+     * \param caller the name of the calling function, used in the error messages
+     */
+    ReshapeOffsets(const std::vector<std::vector<size_t>>& lengths, const char* caller) {
+        if (lengths.empty()) {
+            throw std::runtime_error(std::string(caller) + " : the shape has no levels");
+        }
+        offsets.resize(lengths.size());
+        for (size_t level = 0; level < lengths.size(); ++level) {
+            if (level > 0 && lengths[level].size() != offsets[level - 1].back()) {
+                throw std::runtime_error(std::string(caller) + " : the lengths do not match the previous level");
+            }
+            std::vector<size_t>& levelOffsets = offsets[level];
+            levelOffsets.reserve(lengths[level].size() + 1);
+            levelOffsets.push_back(0);
+            for (size_t length : lengths[level]) levelOffsets.push_back(levelOffsets.back() + length);
+            levels.push_back(ReshapeLevel{levelOffsets.data(), 0});
+        }
+        topLength = lengths.front().size();
+        scalars = offsets.back().back();
+    }
+    /** \brief The levels of a C array having the given bounds
+     *  (`dimensionality` >= 2): no offsets are stored
+     */
+    ReshapeOffsets(const size_t* bounds, size_t dimensionality) {
+        scalars = 1;
+        for (size_t level = 0; level < dimensionality; ++level) {
+            scalars *= bounds[level];
+            if (level + 1 < dimensionality) levels.push_back(ReshapeLevel{nullptr, bounds[level + 1]});
+        }
+        topLength = bounds[0];
+    }
+    ReshapeOffsets(ReshapeOffsets&&) = default;
+    ReshapeOffsets(const ReshapeOffsets&) = delete;
+    ReshapeOffsets& operator=(const ReshapeOffsets&) = delete;
+
+    /** \brief The number of scalar elements of the structure */
+    size_t scalarCount() const {return scalars;}
+
+    std::vector<std::vector<size_t>> offsets;
+        // the prefix offsets of the jagged levels
+    std::vector<ReshapeLevel> levels;
+    size_t topLength = 0;
+    size_t scalars = 0;
+};
+
+// **************************************************************************
+// forward declaration of ReshapedRange
+/** \brief A subrange of a ReshapedView: the elements with index in
+ * `[first, last)` of one of its levels.
+ * \param T the type of the scalar elements (possibly const)
+ * \param dimensionality the dimensionality of the range
+ * \ingroup reshaped_view
+ */
+template <typename T, size_t dimensionality>
+class ReshapedRange;
+
+//***************************************************************************
+// ReshapedIterator
+//***************************************************************************
+/** \brief An iterator over the subranges of a ReshapedView.
+ * Being a proxied iterator, it returns the subranges by value: they are
+ * built on the fly from two consecutive entries of a prefix offsets array.
+ * \param T the type of the scalar elements (possibly const)
+ * \param dimensionality the dimensionality of the pointed subranges
+ * \ingroup reshaped_view
+ */
+template <typename T, size_t dimensionality>
+class ReshapedIterator {
+public:
+    // [iterator.traits]
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = ReshapedRange<T, dimensionality>;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    ReshapedIterator() : data_{nullptr}, levels_{nullptr}, index_{0} {}
+    /* \brief Default constructor. */
+
+    /** \param data the flat buffer
+     * \param levels the prefix offsets arrays of the pointed subranges
+     *  and of their descendants
+     * \param index the index of the pointed subrange
+     */
+    ReshapedIterator(T* data, ReshapeLevel const* levels, size_t index) :
+        data_{data}, levels_{levels}, index_{index} {}
+
+    ReshapedIterator(const ReshapedIterator&) = default;
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    // [iterator.iterators]
+    reference operator*() const {
+        return value_type{data_, levels_ + 1, levels_[0][index_], levels_[0][index_ + 1]};
+    }
+    ReshapedIterator& operator++() {++index_; return *this;}
+
+    // [input.iterators] and [output.iterators]
+    bool operator==(const ReshapedIterator& other) const {return index_ == other.index_;}
+    bool operator!=(const ReshapedIterator& other) const {return !((*this) == other);}
+    ReshapedIterator operator++(int) {auto tmp = *this; ++(*this); return tmp;}
+
+    // [bidirectional.iterators]
+    ReshapedIterator& operator--() {--index_; return *this;}
+    ReshapedIterator operator--(int) {auto other = *this; --(*this); return other;}
+
+    // [random.access.iterators]
+    ReshapedIterator& operator+=(difference_type n) {index_ += n; return *this;}
+    ReshapedIterator operator+(difference_type n) const {auto result = (*this); result += n; return result;}
+    friend ReshapedIterator operator+(difference_type n, const ReshapedIterator& other) {return other + n;}
+    ReshapedIterator& operator-=(difference_type n) {return (*this += (-n));}
+    ReshapedIterator operator-(difference_type n) const {return (*this + (-n));}
+
+    difference_type operator-(const ReshapedIterator& other) const {
+        return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+    bool operator<(const ReshapedIterator& other) const {return index_ < other.index_;}
+    bool operator>(const ReshapedIterator& other) const {return index_ > other.index_;}
+    bool operator>=(const ReshapedIterator& other) const {return !((*this) < other);}
+    bool operator<=(const ReshapedIterator& other) const {return !((*this) > other);}
+
+    reference operator[](difference_type n) const {return *(*this + n);}
+
+private: // members
+    T* data_;
+    ReshapeLevel const* levels_;
+    size_t index_;
+};
+
+//***************************************************************************
+// ReshapedRange
+//***************************************************************************
+// Version for multilevel ranges
+template <typename T, size_t dimensionality>
+class ReshapedRange {
+public:
+    using iterator = ReshapedIterator<T, dimensionality - 1>;
+    using const_iterator = iterator;
+        // constness is determined by T
+    using value_type = typename iterator::value_type;
+    using reference = typename iterator::reference;
+    using const_reference = reference;
+    using difference_type = ptrdiff_t;
+    using size_type = size_t;
+
+    ReshapedRange() : data_{nullptr}, levels_{nullptr}, first_{0}, last_{0} {}
+    ReshapedRange(T* data, ReshapeLevel const* levels, size_t first, size_t last) :
+        data_{data}, levels_{levels}, first_{first}, last_{last} {}
+
+    iterator begin() const {return iterator{data_, levels_, first_};}
+    const_iterator cbegin() const {return begin();}
+    iterator end() const {return iterator{data_, levels_, last_};}
+    const_iterator cend() const {return end();}
+
+    reference operator[](size_type n) const {return begin()[static_cast<difference_type>(n)];}
+    size_type size() const {return last_ - first_;}
+    bool empty() const {return (size() == 0);}
+
+private:
+    T* data_;
+    ReshapeLevel const* levels_;
+    size_t first_;
+    size_t last_;
+};
+
+// Version for monolevel ranges: a contiguous span of the buffer
+template <typename T>
+class ReshapedRange<T, 1> {
+public:
+    using iterator = T*;
+    using const_iterator = iterator;
+    using value_type = typename std::remove_const<T>::type;
+    using reference = T&;
+    using const_reference = reference;
+    using difference_type = ptrdiff_t;
+    using size_type = size_t;
+
+    ReshapedRange() : data_{nullptr}, first_{0}, last_{0} {}
+    ReshapedRange(T* data, ReshapeLevel const*, size_t first, size_t last) :
+        data_{data}, first_{first}, last_{last} {}
+
+    iterator begin() const {return data_ + first_;}
+    const_iterator cbegin() const {return begin();}
+    iterator end() const {return data_ + last_;}
+    const_iterator cend() const {return end();}
+
+    reference operator[](size_type n) const {return data_[first_ + n];}
+    size_type size() const {return last_ - first_;}
+    bool empty() const {return (size() == 0);}
+
+private:
+    T* data_;
+    size_t first_;
+    size_t last_;
+};
+
+//***************************************************************************
+// ReshapedView
+//***************************************************************************
+/** \brief A range which makes a flat buffer appear as a nested container,
+ * jagged or boxed, without copying it.
+ * Level `L` of the structure is described by a prefix offsets array:
+ * the `i`-th subrange of that level spans the elements
+ * `[offsets[L][i], offsets[L][i+1])` of the following level (or of the buffer).
+ * Therefore, the subranges are built on the fly and cost no allocation.
+ * Being a range, it can be passed to all the functions of the library
+ * (`dimensionality`, `bounds`, `makeFlatView`, `makeBoxedView`...).
+ * \note The buffer is not copied, so it must outlive the View. The offsets
+ *  are shared among the copies of the View.
+ * \param T the type of the scalar elements (possibly const)
+ * \ingroup reshaped_view
+ */
+template <typename T, size_t dimensionality>
+class ReshapedView : public ReshapedRange<T, dimensionality> {
+public:
+    /** \param data the flat buffer
+     * \param lengths for each level except the last one, the lengths of its
+     *  subranges (i.e. the number of elements they hold in the following level)
+     */
+    ReshapedView(T* data, const std::vector<std::vector<size_t>>& lengths) :
+        ReshapedView{data, buildOffsets(lengths)} {}
+    /** \param data the flat buffer
+     * \param bounds the bounds of the View: its subranges are located
+     *  by multiplication, without any offsets array
+     */
+    ReshapedView(T* data, const std::array<size_t, dimensionality>& bounds) :
+        ReshapedView{data, std::make_shared<const ReshapeOffsets>(bounds.data(), dimensionality)} {}
+
+private:
+    ReshapedView(T* data, std::shared_ptr<const ReshapeOffsets> offsets) :
+        ReshapedRange<T, dimensionality>{data, offsets->levels.data(), 0, offsets->topLength},
+        offsets_{std::move(offsets)} {}
+
+    static std::shared_ptr<const ReshapeOffsets> buildOffsets(const std::vector<std::vector<size_t>>& lengths) {
+        if (lengths.size() + 1 != dimensionality) {
+            throw std::runtime_error("makeReshapedView : wrong number of levels");
+        }
+        return std::make_shared<ReshapeOffsets>(lengths, "makeReshapedView");
+    }
+
+private:
+    std::shared_ptr<const ReshapeOffsets> offsets_;
+};
+
+// Version for monolevel Views: a span of the buffer
+template <typename T>
+class ReshapedView<T, 1> : public ReshapedRange<T, 1> {
+public:
+    ReshapedView(T* data, size_t length) :
+        ReshapedRange<T, 1>{data, nullptr, 0, length} {}
+};
+
+//***************************************************************************
+// makeReshapedView
+//***************************************************************************
+/** \fn makeReshapedView(T* data, const std::vector<size_t>& rowLengths, const Lengths&... subrowLengths)
+ * \brief Factory method to build a jagged ReshapedView of a flat buffer,
+ * e.g. `makeReshapedView(data, std::vector<size_t>{2, 0, 3})` shows the
+ * first 5 elements of `data` as the rows `{d0, d1}, {}, {d2, d3, d4}`.
+ * \ingroup user_functions
+ * \param data the flat buffer
+ * \param rowLengths the lengths of the rows of the outermost dimension
+ * \param subrowLengths (optional) for deeper Views, the lengths of the
+ *  subranges of each following dimension, in order: each vector holds
+ *  one entry for each subrange of the previous dimension
+ */
+template <typename T, typename... Lengths>
+auto makeReshapedView(T* data, const std::vector<size_t>& rowLengths, const Lengths&... subrowLengths)
+    -> ReshapedView<T, 2 + sizeof...(Lengths)>
+{
+    return ReshapedView<T, 2 + sizeof...(Lengths)>{
+        data, std::vector<std::vector<size_t>>{rowLengths, subrowLengths...}
+    };
+}
+
+/** \fn makeReshapedView(T* data, const std::vector<std::vector<size_t>>& lengths)
+ * \brief Factory method to build a jagged ReshapedView of a flat buffer
+ * from the lengths of all its levels at once, e.g. from the shape
+ * stored by `toSoa` or passed to `buildNested`:
+ * `makeReshapedView<2>(data, {{2, 0, 3}})`.
+ * Throws `std::runtime_error` if `lengths` does not hold
+ * `dimensionality - 1` levels.
+ * \ingroup user_functions
+ * \param dimensionality the dimensionality of the View (not deduced)
+ * \param data the flat buffer
+ * \param lengths for each level except the last one, the lengths
+ *  of its subranges
+ */
+template <size_t dimensionality, typename T>
+auto makeReshapedView(T* data, const std::vector<std::vector<size_t>>& lengths)
+    -> ReshapedView<T, dimensionality>
+{
+    static_assert(dimensionality >= 2, "makeReshapedView : a jagged View has at least 2 dimensions");
+    return ReshapedView<T, dimensionality>{data, lengths};
+}
+
+/** \fn makeReshapedView(T* data, const std::array<size_t, dimensionality>& bounds)
+ * \brief Factory method to build a boxed ReshapedView of a flat buffer,
+ * i.e. one showing it as a C array with the given bounds (in row-major
+ * order), e.g. `makeReshapedView(data, std::array<size_t, 2>{{2, 3}})`.
+ * The subranges are located by multiplication, so the View stores
+ * no offsets. The bounds must be given as an `std::array`: a braced
+ * list, e.g. `makeReshapedView(data, {2, 0, 3})`, always means the lengths
+ * of the rows of a jagged View.
+ * \ingroup user_functions
+ * \param data the flat buffer
+ * \param bounds the bounds of the View
+ */
+template <typename T, size_t dimensionality>
+auto makeReshapedView(T* data, const std::array<size_t, dimensionality>& bounds)
+    -> ReshapedView<T, dimensionality>
+{
+    static_assert(dimensionality > 0, "makeReshapedView : bounds cannot be empty");
+    return ReshapedView<T, dimensionality>{data, bounds};
+}
+
+template <typename T>
+auto makeReshapedView(T* data, const std::array<size_t, 1>& bounds)
+    -> ReshapedView<T, 1>
+{
+    return ReshapedView<T, 1>{data, bounds[0]};
+}
+
+
+//***************************************************************************
+// buildNested
+//***************************************************************************
+// Fills `container` with the elements [first, last) of its level;
+// `cursor` points to the first scalar element of the container,
+// and is moved past its last one
+
+// Version for bottom-level containers: the elements are copied in bulk
+template <
+    template<typename> class ScalarPolicy,
+    typename Container,
+    typename Iterator,
+    typename std::enable_if<
+        (true == IsScalar<ScalarPolicy, typename Container::value_type>::value),
+        long
+    >::type = 0xBEEF
+>
+void fillNested(Container& container, size_t first, size_t last, ReshapeLevel const*, Iterator& cursor) {
+    const auto rowFirst = cursor;
+    std::advance(cursor, static_cast<ptrdiff_t>(last - first));
+    container.assign(rowFirst, cursor);
+}
+
+// Version for multilevel containers
+template <
+    template<typename> class ScalarPolicy,
+    typename Container,
+    typename Iterator,
+    typename std::enable_if<
+        (false == IsScalar<ScalarPolicy, typename Container::value_type>::value),
+        int
+    >::type = 0xBEEF
+>
+void fillNested(Container& container, size_t first, size_t last, ReshapeLevel const* levels, Iterator& cursor) {
+    container.resize(last - first);
+    size_t index = first;
+    for (auto it = begin(container); it != end(container); ++it, ++index) {
+        fillNested<ScalarPolicy>(*it, levels[0][index], levels[0][index + 1], levels + 1, cursor);
+    }
+}
+
+// Builds the container from the levels of its shape, see buildNested
+template <
+    typename Nested,
+    template<typename> class ScalarPolicy,
+    typename Iterator
+>
+Nested buildNestedFrom(
+    Iterator flatFirst, Iterator flatLast, const ReshapeOffsets& offsets, Executor& executor
+) {
+    static_assert(
+        std::is_base_of<
+            std::forward_iterator_tag,
+            typename std::iterator_traits<Iterator>::iterator_category
+        >::value,
+        "buildNested : the flat range must be at least a forward range"
+    );
+    if (offsets.scalarCount() != static_cast<size_t>(std::distance(flatFirst, flatLast))) {
+        throw std::runtime_error("buildNested : the shape does not match the number of elements");
+    }
+
+    Nested result;
+    result.resize(offsets.topLength);
+    const size_t chunkCount = std::min(
+        parallelChunkCount(executor, offsets.scalarCount(), 1024),
+        std::max<size_t>(offsets.topLength, 1)
+    );
+    parallelChunks(executor, offsets.topLength, chunkCount,
+        [&](size_t, size_t chunkBegin, size_t chunkEnd) {
+            // The position of the first scalar element of the chunk;
+            // from there, a single cursor walks through the chunk
+            size_t position = chunkBegin;
+            for (const ReshapeLevel& level : offsets.levels) position = level[position];
+            auto cursor = std::next(flatFirst, static_cast<ptrdiff_t>(position));
+            auto row = std::next(begin(result), chunkBegin);
+            for (size_t index = chunkBegin; index < chunkEnd; ++index, ++row) {
+                fillNested<ScalarPolicy>(
+                    *row, offsets.levels[0][index], offsets.levels[0][index + 1],
+                    offsets.levels.data() + 1, cursor
+                );
+            }
+        }
+    );
+    return result;
+}
+
+/** \fn buildNested(Iterator flatFirst, Iterator flatLast, const std::vector<std::vector<size_t>>& lengths, Executor& executor)
+ * \brief Builds a nested container from a flat range and its shape:
+ * the counterpart of FlatView.
+ * Each subcontainer is sized exactly from the shape (no regrowth)
+ * and the bottom-level ones are filled with bulk copies.
+ * The rows of the outermost dimension are filled in parallel.
+ * \ingroup user_functions
+ * \param Nested the type of the result, e.g. `vector<vector<int>>`.
+ *  Its subcontainers must support `resize` and `assign`
+ * \param ScalarPolicy (trait template)
+ * \param flatFirst, flatLast the scalar elements, in the order of a FlatView
+ *  (a forward range: it is traversed once to check its length and once
+ *  to copy it, in O(n) even without random access)
+ * \param lengths the shape, in the same format as `makeReshapedView`:
+ *  for each level except the last one, the lengths of its subranges
+ * \param executor the Executor on which the rows are filled
+ */
+template <
+    typename Nested,
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Iterator = void
+>
+Nested buildNested(
+    Iterator flatFirst, Iterator flatLast,
+    const std::vector<std::vector<size_t>>& lengths,
+    Executor& executor = defaultExecutor()
+) {
+    static_assert(
+        Dimensionality<ScalarPolicy, Nested>::value >= 2,
+        "buildNested : Nested must be a container of containers"
+    );
+    if (lengths.size() + 1 != Dimensionality<ScalarPolicy, Nested>::value) {
+        throw std::runtime_error("buildNested : wrong number of levels");
+    }
+    return buildNestedFrom<Nested, ScalarPolicy>(
+        flatFirst, flatLast, ReshapeOffsets{lengths, "buildNested"}, executor
+    );
+}
+
+/** \brief Builds a nested container, having the given bounds, from a flat range
+ * (in row-major order), see the other overload.
+ * As in `makeReshapedView`, the bounds must be a `std::array`
+ * (braced lists are taken as jagged lengths).
+ * \ingroup user_functions
+ */
+template <
+    typename Nested,
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Iterator = void,
+    size_t dimensionality = 0
+>
+Nested buildNested(
+    Iterator flatFirst, Iterator flatLast,
+    const std::array<size_t, dimensionality>& bounds,
+    Executor& executor = defaultExecutor()
+) {
+    static_assert(
+        Dimensionality<ScalarPolicy, Nested>::value >= 2,
+        "buildNested : Nested must be a container of containers"
+    );
+    if (dimensionality != Dimensionality<ScalarPolicy, Nested>::value) {
+        throw std::runtime_error("buildNested : wrong number of levels");
+    }
+    return buildNestedFrom<Nested, ScalarPolicy>(
+        flatFirst, flatLast, ReshapeOffsets{bounds.data(), dimensionality}, executor
+    );
+}
+
+} // namespace multidim - ReshapedView
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @Histogram
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// HistogramBins
+//***************************************************************************
+/** \brief The bins of a histogram: `count` bins of equal width
+ * covering `[low, high)`. Values outside this interval (or NaN)
+ * are not counted.
+ * \ingroup user_functions
+ */
+struct HistogramBins {
+    double low = 0;
+    double high = 1;
+    size_t count = 1;
+
+    /** \brief The index of the bin of `value`, or `count` if it is outside.
+     * Branchless, so that a loop of calls can be vectorised */
+    template <typename T>
+    size_t index(const T& value) const {
+        const double position = (static_cast<double>(value) - low) * scale();
+        const bool inside = (position >= 0) && (position < static_cast<double>(count));
+        return inside ? static_cast<size_t>(position) : count;
+    }
+
+    double scale() const {return static_cast<double>(count) / (high - low);}
+};
+
+// Adds the scalar elements of a segment to `bins`, which has an extra
+// slot (at the end) for the values outside the bins.
+// The bin indices are computed a block at a time, in a loop with no
+// dependencies, then the counters are incremented.
+template <typename SegmentIterator>
+void binSegment(SegmentIterator first, size_t count, const HistogramBins& spec, size_t* bins) {
+    constexpr size_t blockSize = 64;
+    size_t indices[blockSize];
+    while (count > 0) {
+        const size_t block = std::min(count, blockSize);
+        for (size_t i = 0; i < block; ++i, ++first) indices[i] = spec.index(*first);
+        for (size_t i = 0; i < block; ++i) ++bins[indices[i]];
+        count -= block;
+    }
+}
+
+// Sums partial results pairwise, in log2(partials.size()) parallel rounds.
+// The result is left in partials[0]
+inline void treeMerge(std::vector<std::vector<size_t>>& partials, Executor& executor) {
+    for (size_t stride = 1; stride < partials.size(); stride *= 2) {
+        const size_t pairCount = (partials.size() + 2 * stride - 1) / (2 * stride);
+        executor.bulkExecute(pairCount, [&](size_t pair) {
+            const size_t target = pair * 2 * stride;
+            if (target + stride >= partials.size()) return;
+            std::vector<size_t>& destination = partials[target];
+            const std::vector<size_t>& source = partials[target + stride];
+            for (size_t bin = 0; bin < destination.size(); ++bin) destination[bin] += source[bin];
+        });
+    }
+}
+
+// Computes the histogram of a FlatView or TransformedFlatView, see histogram
+template <typename View>
+std::vector<size_t> histogramOf(const View& view, const HistogramBins& bins, Executor& executor) {
+    if (bins.count == 0 || !(bins.low < bins.high)) {
+        throw std::runtime_error("histogram : invalid bins");
+    }
+
+    const auto parts = view.split(parallelChunkCount(executor, view.size(), 4096));
+    std::vector<std::vector<size_t>> partials(parts.size());
+    executor.bulkExecute(parts.size(), [&](size_t part) {
+        std::vector<size_t> partial(bins.count + 1, 0);
+            // the last slot collects the values outside the bins
+        forEachSegment(parts[part], [&](typename View::const_iterator::SegmentIterator first, size_t count) {
+            binSegment(first, count, bins, partial.data());
+        });
+        partials[part] = std::move(partial);
+    });
+
+    treeMerge(partials, executor);
+    std::vector<size_t> result = std::move(partials.front());
+    result.pop_back();
+    return result;
+}
+
+//***************************************************************************
+// histogram
+//***************************************************************************
+/** \brief Computes in parallel the histogram of the scalar elements of a
+ * FlatView, which must be convertible to `double`.
+ * The View is split among the threads of the Executor; each thread counts
+ * in its own bins, processing a segment (a run of adjacent elements)
+ * at a time, so that no atomic operation is needed. Finally, the partial
+ * histograms are summed pairwise.
+ * \ingroup user_functions
+ * \param view the View whose elements are counted
+ * \param bins the bins of the histogram
+ * \param executor the Executor on which the histogram is computed
+ * \return the number of elements in each bin
+ */
+template <template<typename> class ScalarPolicy, typename RawIterator>
+std::vector<size_t> histogram(
+    const FlatView<ScalarPolicy, RawIterator>& view,
+    const HistogramBins& bins,
+    Executor& executor = defaultExecutor()
+) {
+    return histogramOf(view, bins, executor);
+}
+
+/** \brief The same, on the elements of a TransformedFlatView
+ * (e.g. a projection, see FlatView::project)
+ */
+template <template<typename> class ScalarPolicy, typename RawIterator, typename Function>
+std::vector<size_t> histogram(
+    const TransformedFlatView<ScalarPolicy, RawIterator, Function>& view,
+    const HistogramBins& bins,
+    Executor& executor = defaultExecutor()
+) {
+    return histogramOf(view, bins, executor);
+}
+
+//***************************************************************************
+// countByRow
+//***************************************************************************
+/** \brief Counts in parallel, for each element of the outermost dimension of
+ * a container (a "row"), how many of its scalar elements satisfy `predicate`.
+ * The rows are distributed among the threads of the Executor, and each
+ * row is processed a segment at a time.
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ * \param container a container of containers
+ * \param predicate the condition to be counted
+ * \param executor the Executor on which the counts are computed
+ * \return the count for each row
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename Predicate = void
+>
+std::vector<size_t> countByRow(
+    Container& container,
+    const Predicate& predicate,
+    Executor& executor = defaultExecutor()
+) {
+    static_assert(
+        Dimensionality<ScalarPolicy, Container>::value >= 2,
+        "countByRow : the container must be a container of containers"
+    );
+    const size_t rowCount = size(container);
+    std::vector<size_t> result(rowCount, 0);
+    parallelChunks(executor, rowCount, parallelChunkCount(executor, rowCount, 16),
+        [&](size_t, size_t chunkBegin, size_t chunkEnd) {
+            auto row = std::next(begin(container), chunkBegin);
+            for (size_t index = chunkBegin; index < chunkEnd; ++index, ++row) {
+                auto&& rowRange = *row;
+                size_t count = 0;
+                forEachSegment(makeFlatView<ScalarPolicy>(rowRange), [&](
+                    typename FlatView<ScalarPolicy, decltype(begin(rowRange))>::iterator::SegmentIterator first,
+                    size_t segmentCount
+                ) {
+                    for (size_t i = 0; i < segmentCount; ++i, ++first) {
+                        if (predicate(*first)) ++count;
+                    }
+                });
+                result[index] = count;
+            }
+        }
+    );
+    return result;
+}
+
+} // namespace multidim - Histogram
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @TopK
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// TopKElement
+//***************************************************************************
+/** \brief An element selected by `topK` or `topKPerRow`
+ * \ingroup user_functions
+ */
+template <typename T>
+struct TopKElement {
+    T value;
+    std::vector<size_t> indices;
+        /**< the multi-index of the element in the container */
+};
+
+// An element being selected, identified by its position in the FlatView
+template <typename T>
+struct TopKCandidate {
+    T value;
+    size_t position;
+};
+
+// Order of selection: larger values first, ties broken by position
+template <typename T>
+bool isBetterCandidate(const TopKCandidate<T>& a, const TopKCandidate<T>& b) {
+    return (b.value < a.value) || (!(a.value < b.value) && (a.position < b.position));
+}
+
+// Keeps the best k candidates of `candidates`, sorted
+template <typename T>
+void selectBestCandidates(std::vector<TopKCandidate<T>>& candidates, size_t k) {
+    if (candidates.size() > k) {
+        std::nth_element(
+            candidates.begin(), candidates.begin() + static_cast<ptrdiff_t>(k), candidates.end(),
+            isBetterCandidate<T>
+        );
+        candidates.resize(k);
+    }
+    std::sort(candidates.begin(), candidates.end(), isBetterCandidate<T>);
+}
+
+//***************************************************************************
+// locatePositions
+//***************************************************************************
+// Converts positions in a FlatView (in ascending order, paired with the slot
+// of `result` to be filled) into multi-indices, in one walk of the range.
+// Subranges holding no requested position are jumped using their scalarSize
+
+// Version for monolevel ranges
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    typename std::enable_if<
+        (true == IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value),
+        long
+    >::type = 0xBEEF
+>
+void locatePositions(
+    Iterator first, Iterator last, size_t base,
+    const std::pair<size_t, size_t>*& next, const std::pair<size_t, size_t>* positionsEnd,
+    std::vector<size_t>& prefix, std::vector<std::vector<size_t>>& result
+) {
+    const size_t length = static_cast<size_t>(std::distance(first, last));
+    for (; next != positionsEnd && next->first < base + length; ++next) {
+        result[next->second] = prefix;
+        result[next->second].push_back(next->first - base);
+    }
+}
+
+// Version for multilevel ranges
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    typename std::enable_if<
+        (false == IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value),
+        int
+    >::type = 0xBEEF
+>
+void locatePositions(
+    Iterator first, Iterator last, size_t base,
+    const std::pair<size_t, size_t>*& next, const std::pair<size_t, size_t>* positionsEnd,
+    std::vector<size_t>& prefix, std::vector<std::vector<size_t>>& result
+) {
+    size_t index = 0;
+    for (auto it = first; it != last && next != positionsEnd; ++it, ++index) {
+        const size_t length = scalarSize<ScalarPolicy>(*it);
+        if (next->first < base + length) {
+            prefix.push_back(index);
+            locatePositions<ScalarPolicy>(begin(*it), end(*it), base, next, positionsEnd, prefix, result);
+            prefix.pop_back();
+        }
+        base += length;
+    }
+}
+
+// Builds the result of topK from the selected candidates
+template <template<typename> class ScalarPolicy, typename Iterator, typename T>
+std::vector<TopKElement<T>> makeTopKElements(
+    Iterator first, Iterator last,
+    std::vector<TopKCandidate<T>>& candidates,
+    std::vector<size_t> prefix
+) {
+    std::vector<std::pair<size_t, size_t>> positions;
+    positions.reserve(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) positions.emplace_back(candidates[i].position, i);
+    std::sort(positions.begin(), positions.end());
+
+    std::vector<std::vector<size_t>> indices(candidates.size());
+    const std::pair<size_t, size_t>* next = positions.data();
+    locatePositions<ScalarPolicy>(first, last, 0, next, next + positions.size(), prefix, indices);
+
+    std::vector<TopKElement<T>> result;
+    result.reserve(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        result.push_back(TopKElement<T>{std::move(candidates[i].value), std::move(indices[i])});
+    }
+    return result;
+}
+
+//***************************************************************************
+// topK
+//***************************************************************************
+/** \brief Selects in parallel the `k` largest scalar elements of a
+ * nested container (according to `operator<`; ties are broken in favor
+ * of the element coming first in a FlatView).
+ * The container is split among the threads of the Executor; each thread
+ * keeps a bounded heap of its best `k` elements while scanning its part
+ * a segment at a time, then the heaps are merged.
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ * \param container the container whose elements are selected
+ * \param k the number of elements to select
+ * \param executor the Executor on which the selection is made
+ * \return the selected elements, largest first, with their multi-indices
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void
+>
+auto topK(Container& container, size_t k, Executor& executor = defaultExecutor())
+    -> std::vector<TopKElement<typename IteratorScalarType<ScalarPolicy, decltype(begin(container))>::type>>
+{
+    using T = typename IteratorScalarType<ScalarPolicy, decltype(begin(container))>::type;
+    using View = FlatView<ScalarPolicy, decltype(begin(container))>;
+    using Candidate = TopKCandidate<T>;
+
+    const View view = makeFlatView<ScalarPolicy>(container);
+    const size_t totalSize = view.size();
+    const auto parts = view.split(parallelChunkCount(executor, totalSize, std::max<size_t>(4096, k)));
+    std::vector<std::vector<Candidate>> heaps(parts.size());
+
+    executor.bulkExecute(parts.size(), [&](size_t part) {
+        // same partition as split()
+        size_t position = totalSize * part / parts.size();
+        std::vector<Candidate>& heap = heaps[part];
+        heap.reserve(std::min(k, parts[part].size()));
+        forEachSegment(parts[part], [&](typename View::iterator::SegmentIterator first, size_t count) {
+            for (size_t i = 0; i < count; ++i, ++first, ++position) {
+                if (heap.size() < k) {
+                    heap.push_back(Candidate{*first, position});
+                    std::push_heap(heap.begin(), heap.end(), isBetterCandidate<T>);
+                } else if (k > 0 && heap.front().value < *first) {
+                    // the worst retained element is at the front
+                    std::pop_heap(heap.begin(), heap.end(), isBetterCandidate<T>);
+                    heap.back() = Candidate{*first, position};
+                    std::push_heap(heap.begin(), heap.end(), isBetterCandidate<T>);
+                }
+            }
+        });
+    });
+
+    std::vector<Candidate> candidates;
+    for (auto& heap : heaps) {
+        candidates.insert(candidates.end(), std::make_move_iterator(heap.begin()), std::make_move_iterator(heap.end()));
+    }
+    selectBestCandidates(candidates, k);
+    return makeTopKElements<ScalarPolicy>(begin(container), end(container), candidates, {});
+}
+
+//***************************************************************************
+// topKPerRow
+//***************************************************************************
+/** \brief Selects in parallel the `k` largest scalar elements of each
+ * element of the outermost dimension of a container (a "row"),
+ * see `topK`. The rows are distributed among the threads of the Executor;
+ * the elements of each row are copied in a per-thread buffer and selected
+ * with `std::nth_element`.
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ * \param container a container of containers
+ * \param k the number of elements to select in each row
+ * \param executor the Executor on which the selection is made
+ * \return for each row, the selected elements, largest first, with their
+ *  multi-indices in `container` (the first index being the row)
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void
+>
+auto topKPerRow(Container& container, size_t k, Executor& executor = defaultExecutor())
+    -> std::vector<std::vector<TopKElement<typename IteratorScalarType<ScalarPolicy, decltype(begin(container))>::type>>>
+{
+    static_assert(
+        Dimensionality<ScalarPolicy, Container>::value >= 2,
+        "topKPerRow : the container must be a container of containers"
+    );
+    using T = typename IteratorScalarType<ScalarPolicy, decltype(begin(container))>::type;
+    using Candidate = TopKCandidate<T>;
+
+    const size_t rowCount = size(container);
+    std::vector<std::vector<TopKElement<T>>> result(rowCount);
+    parallelChunks(executor, rowCount, parallelChunkCount(executor, rowCount, 16),
+        [&](size_t, size_t chunkBegin, size_t chunkEnd) {
+            std::vector<Candidate> buffer;
+                // reused by all the rows of the chunk
+            auto row = std::next(begin(container), chunkBegin);
+            for (size_t index = chunkBegin; index < chunkEnd; ++index, ++row) {
+                auto&& rowRange = *row;
+                buffer.clear();
+                size_t position = 0;
+                forEachSegment(makeFlatView<ScalarPolicy>(rowRange), [&](
+                    typename FlatView<ScalarPolicy, decltype(begin(rowRange))>::iterator::SegmentIterator first,
+                    size_t count
+                ) {
+                    for (size_t i = 0; i < count; ++i, ++first, ++position) {
+                        buffer.push_back(Candidate{*first, position});
+                    }
+                });
+                selectBestCandidates(buffer, k);
+                result[index] = makeTopKElements<ScalarPolicy>(
+                    begin(rowRange), end(rowRange), buffer, std::vector<size_t>{index}
+                );
+            }
+        }
+    );
+    return result;
+}
+
+} // namespace multidim - TopK
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @WindowView
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// IsContiguousIterator
+//***************************************************************************
+/** \brief Provides the member constant `value`, which is `true` if
+ * `Iterator` is known to point to elements stored contiguously in memory
+ * (pointers and `std::vector` iterators), `false` otherwise
+ * \ingroup detail
+ */
+template <
+    typename Iterator,
+    typename T = typename std::iterator_traits<Iterator>::value_type
+>
+struct IsContiguousIterator {
+    static constexpr bool value =
+           std::is_pointer<Iterator>::value
+        || (
+                !std::is_same<T, bool>::value
+             && (
+                    std::is_same<Iterator, typename std::vector<T>::iterator>::value
+                 || std::is_same<Iterator, typename std::vector<T>::const_iterator>::value
+                )
+           )
+    ;
+};
+
+//***************************************************************************
+// WindowSpan
+//***************************************************************************
+/** \brief A window of WindowView: a read-only span of contiguous elements
+ * \ingroup flat_view_adaptors
+ */
+template <typename T>
+class WindowSpan {
+public:
+    using iterator = T const*;
+    using const_iterator = iterator;
+    using value_type = T;
+    using size_type = size_t;
+
+    WindowSpan(T const* first, size_t size) : first_{first}, size_{size} {}
+
+    iterator begin() const {return first_;}
+    iterator end() const {return first_ + size_;}
+    const T& operator[](size_type n) const {return first_[n];}
+    size_type size() const {return size_;}
+    bool empty() const {return (size_ == 0);}
+
+private:
+    T const* first_;
+    size_t size_;
+};
+
+//***************************************************************************
+// WindowViewIterator
+//***************************************************************************
+/** \brief The iterator used in WindowView.
+ * If a window lies within one segment (a run of elements adjacent in
+ * the underlying container, e.g. a row of a `vector<vector<T>>`) it is
+ * returned in place. Otherwise its elements are copied in a ring buffer
+ * of the window size: since each element is written twice, at positions
+ * `i` and `i + windowSize`, the window is always contiguous in the buffer,
+ * and the elements shared by consecutive windows are copied only once.
+ * Being a single pass iterator, it is an input iterator.
+ * \param FlatViewIteratorType the iterator of the underlying FlatView
+ * \ingroup flat_view_adaptors
+ */
+template <typename FlatViewIteratorType>
+class WindowViewIterator {
+public:
+    using ScalarType = typename std::remove_const<typename FlatViewIteratorType::value_type>::type;
+
+    // [iterator.traits]
+    using iterator_category = std::input_iterator_tag;
+    using value_type = WindowSpan<ScalarType>;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    WindowViewIterator() = default;
+    /* \brief Default constructor. */
+
+    /** \param first the beginning of the underlying FlatView
+     * \param viewSize the number of scalar elements of the underlying FlatView
+     * \param windowSize, stride see WindowView
+     * \param windowCount the number of windows of the View
+     */
+    static WindowViewIterator makeBegin(
+        FlatViewIteratorType first, size_t viewSize,
+        size_t windowSize, size_t stride, size_t windowCount
+    ) {
+        WindowViewIterator result;
+        result.cursor_ = first;
+        result.viewLeft_ = viewSize;
+        result.windowSize_ = windowSize;
+        result.stride_ = stride;
+        result.windowCount_ = windowCount;
+        if (viewSize > 0) result.loadSegment();
+        if (windowCount > 0) result.prepareWindow();
+        return result;
+    }
+    static WindowViewIterator makeEnd(size_t windowCount) {
+        WindowViewIterator result;
+        result.window_ = windowCount;
+        return result;
+    }
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    // [iterator.iterators]
+    reference operator*() const {
+        if (inPlace_) return value_type{inPlaceData_, windowSize_};
+        return value_type{ring_.data() + position() % windowSize_, windowSize_};
+    }
+    WindowViewIterator& operator++() {
+        ++window_;
+        if (window_ < windowCount_) prepareWindow();
+        return *this;
+    }
+
+    // [input.iterators]
+    bool operator==(const WindowViewIterator& other) const {return window_ == other.window_;}
+    bool operator!=(const WindowViewIterator& other) const {return !((*this) == other);}
+
+    // **************************************************************************
+
+    /** \brief The position of the first element of the window in the FlatView */
+    size_t position() const {return window_ * stride_;}
+
+private: // funcs
+    using SegmentIterator = typename FlatViewIteratorType::SegmentIterator;
+    static constexpr bool isContiguous = IsContiguousIterator<SegmentIterator>::value;
+
+    // Loads the segment under cursor_, clipped to the end of the View
+    void loadSegment() {
+        segmentFirst_ = cursor_.segmentBegin();
+        segmentLength_ = std::min(
+            static_cast<size_t>(std::distance(segmentFirst_, cursor_.segmentEnd())), viewLeft_
+        );
+        viewLeft_ -= segmentLength_;
+        reader_ = segmentFirst_;
+        readerPosition_ = segmentStart_;
+    }
+
+    void nextSegment() {
+        segmentStart_ += segmentLength_;
+        cursor_.nextSegment();
+        loadSegment();
+    }
+
+    size_t segmentEnd() const {return segmentStart_ + segmentLength_;}
+
+    static ScalarType const* address(SegmentIterator it, std::true_type) {return &*it;}
+    static ScalarType const* address(SegmentIterator, std::false_type) {return nullptr;}
+
+    // Returns the element at `target`, which must be in the current segment,
+    // not before the last element read
+    SegmentIterator elementAt(size_t target) {
+        std::advance(reader_, static_cast<difference_type>(target - readerPosition_));
+        readerPosition_ = target;
+        return reader_;
+    }
+
+    void prepareWindow() {
+        const size_t first = position();
+        const size_t last = first + windowSize_;
+
+        // move to the segment holding the first element
+        // (the ring holds no element after it)
+        while (first >= segmentEnd() && viewLeft_ > 0) nextSegment();
+
+        inPlace_ = isContiguous && (first >= segmentStart_) && (last <= segmentEnd());
+        if (inPlace_) {
+            inPlaceData_ = address(elementAt(first), std::integral_constant<bool, isContiguous>{});
+            return;
+        }
+
+        // copy in the ring the elements not already there
+        if (ring_.empty()) ring_.resize(2 * windowSize_);
+        if (ringEnd_ < first) ringEnd_ = first;
+        for (; ringEnd_ < last; ++ringEnd_) {
+            while (ringEnd_ >= segmentEnd()) nextSegment();
+            const size_t slot = ringEnd_ % windowSize_;
+            ring_[slot] = *elementAt(ringEnd_);
+            ring_[slot + windowSize_] = ring_[slot];
+        }
+    }
+
+private: // members
+    FlatViewIteratorType cursor_{};
+        // positioned on the current segment
+    SegmentIterator segmentFirst_{};
+    size_t segmentStart_ = 0;
+        // position in the View of *segmentFirst_
+    size_t segmentLength_ = 0;
+    size_t viewLeft_ = 0;
+        // elements of the View after the current segment
+    SegmentIterator reader_{};
+    size_t readerPosition_ = 0;
+        // last element accessed in the current segment
+
+    size_t windowSize_ = 0;
+    size_t stride_ = 0;
+    size_t window_ = 0;
+    size_t windowCount_ = 0;
+
+    bool inPlace_ = false;
+    ScalarType const* inPlaceData_ = nullptr;
+    std::vector<ScalarType> ring_;
+    size_t ringEnd_ = 0;
+        // the ring holds the elements before this position (at most windowSize_)
+};
+
+//***************************************************************************
+// WindowView
+//***************************************************************************
+/** \brief A View showing the windows of `windowSize` consecutive scalar
+ * elements of a FlatView, starting every `stride` elements, e.g. to process
+ * a stream stored as a jagged container of chunks. The windows can span
+ * several subranges; they are returned as read-only WindowSpans.
+ * \note The windows returned in place require the bottom-level subranges
+ *  to be contiguous (pointers or `std::vector` iterators); otherwise, all the
+ *  windows are copied in the ring buffer. A window is only valid until the
+ *  iterator is incremented.
+ * \ingroup flat_view_adaptors
+ */
+template <template<typename> class ScalarPolicy, typename RawIterator>
+class WindowView {
+public:
+    using BaseView = FlatView<ScalarPolicy, RawIterator>;
+    using iterator = WindowViewIterator<typename BaseView::const_iterator>;
+    using const_iterator = iterator;
+    using value_type = typename iterator::value_type;
+    using size_type = size_t;
+
+    WindowView(BaseView view, size_t windowSize, size_t stride) :
+        view_{std::move(view)}, windowSize_{windowSize}, stride_{stride}
+    {
+        if (windowSize_ == 0 || stride_ == 0) {
+            throw std::runtime_error("makeWindowView : window size and stride must be > 0");
+        }
+    }
+
+    iterator begin() const {
+        return iterator::makeBegin(view_.cbegin(), view_.size(), windowSize_, stride_, size());
+    }
+    iterator end() const {return iterator::makeEnd(size());}
+    const_iterator cbegin() const {return begin();}
+    const_iterator cend() const {return end();}
+
+    /** \brief The number of windows */
+    size_type size() const {
+        const size_t scalarCount = view_.size();
+        return (scalarCount < windowSize_) ? 0 : (scalarCount - windowSize_) / stride_ + 1;
+    }
+    bool empty() const {return (size() == 0);}
+
+private:
+    BaseView view_;
+    size_t windowSize_;
+    size_t stride_;
+};
+
+//***************************************************************************
+// makeWindowView
+//***************************************************************************
+/** \brief Factory method to build a WindowView.
+ * \ingroup user_functions
+ * \param view the FlatView whose elements are shown
+ * \param windowSize the number of elements of each window
+ * \param stride the distance between the beginnings of consecutive windows
+ */
+template <template<typename> class ScalarPolicy, typename RawIterator>
+auto makeWindowView(
+    const FlatView<ScalarPolicy, RawIterator>& view,
+    size_t windowSize, size_t stride = 1
+) -> WindowView<ScalarPolicy, RawIterator> {
+    return WindowView<ScalarPolicy, RawIterator>{view, windowSize, stride};
+}
+
+} // namespace multidim - WindowView
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @Morton
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// Bit interleaving
+//***************************************************************************
+// In a Morton code of a D-dimensional multi-index, the bit b of the
+// coordinate d is the bit (b * D + D - 1 - d) of the code: the last
+// coordinate, the fastest-varying one in row-major order, takes the
+// least significant bit of each group. Each coordinate can have up to
+// 64 / D significant bits.
+
+// The bits of a Morton code belonging to the coordinate of offset 0
+constexpr uint64_t mortonMask(size_t dimensionality, size_t bit = 0) {
+    return (bit >= 64 / dimensionality) ? 0 :
+        ((uint64_t{1} << (bit * dimensionality)) | mortonMask(dimensionality, bit + 1));
+}
+
+template <size_t dimensionality>
+struct MortonMask {
+    static constexpr uint64_t value = mortonMask(dimensionality);
+};
+
+/** \brief Spreads the low `64 / dimensionality` bits of `value` to every
+ * `dimensionality`-th bit, starting from bit `offset`
+ * \ingroup detail
+ */
+template <size_t dimensionality>
+uint64_t mortonDeposit(uint64_t value, size_t offset) {
+#ifdef __BMI2__
+    return _pdep_u64(value, MortonMask<dimensionality>::value << offset);
+#else
+    switch (dimensionality) {
+    case 1:
+        return value;
+    case 2:
+        value &= 0x00000000FFFFFFFFull;
+        value = (value | (value << 16)) & 0x0000FFFF0000FFFFull;
+        value = (value | (value << 8))  & 0x00FF00FF00FF00FFull;
+        value = (value | (value << 4))  & 0x0F0F0F0F0F0F0F0Full;
+        value = (value | (value << 2))  & 0x3333333333333333ull;
+        value = (value | (value << 1))  & 0x5555555555555555ull;
+        return value << offset;
+    case 3:
+        value &= 0x00000000001FFFFFull;
+        value = (value | (value << 32)) & 0x001F00000000FFFFull;
+        value = (value | (value << 16)) & 0x001F0000FF0000FFull;
+        value = (value | (value << 8))  & 0x100F00F00F00F00Full;
+        value = (value | (value << 4))  & 0x10C30C30C30C30C3ull;
+        value = (value | (value << 2))  & 0x1249249249249249ull;
+        return value << offset;
+    default: {
+        uint64_t result = 0;
+        for (size_t bit = 0; bit < 64 / dimensionality; ++bit) {
+            result |= ((value >> bit) & 1) << (bit * dimensionality + offset);
+        }
+        return result;
+    }
+    }
+#endif
+}
+
+/** \brief Gathers every `dimensionality`-th bit of `code`, starting from
+ * bit `offset`: the inverse of mortonDeposit
+ * \ingroup detail
+ */
+template <size_t dimensionality>
+uint64_t mortonExtract(uint64_t code, size_t offset) {
+#ifdef __BMI2__
+    return _pext_u64(code, MortonMask<dimensionality>::value << offset);
+#else
+    switch (dimensionality) {
+    case 1:
+        return code;
+    case 2:
+        code = (code >> offset) & 0x5555555555555555ull;
+        code = (code ^ (code >> 1))  & 0x3333333333333333ull;
+        code = (code ^ (code >> 2))  & 0x0F0F0F0F0F0F0F0Full;
+        code = (code ^ (code >> 4))  & 0x00FF00FF00FF00FFull;
+        code = (code ^ (code >> 8))  & 0x0000FFFF0000FFFFull;
+        code = (code ^ (code >> 16)) & 0x00000000FFFFFFFFull;
+        return code;
+    case 3:
+        code = (code >> offset) & 0x1249249249249249ull;
+        code = (code ^ (code >> 2))  & 0x10C30C30C30C30C3ull;
+        code = (code ^ (code >> 4))  & 0x100F00F00F00F00Full;
+        code = (code ^ (code >> 8))  & 0x001F0000FF0000FFull;
+        code = (code ^ (code >> 16)) & 0x001F00000000FFFFull;
+        code = (code ^ (code >> 32)) & 0x00000000001FFFFFull;
+        return code;
+    default: {
+        uint64_t result = 0;
+        for (size_t bit = 0; bit < 64 / dimensionality; ++bit) {
+            result |= ((code >> (bit * dimensionality + offset)) & 1) << bit;
+        }
+        return result;
+    }
+    }
+#endif
+}
+
+/** \brief Deposits the low bits of a value to the bits set in a fixed mask
+ * (`pdep`). Without BMI2, the mask is decomposed once into the shifts
+ * of its bits, in 6 steps of 1, 2, 4... 32 positions (see Hacker's Delight,
+ * "Expand"), so that each deposit is a fixed sequence of 6 shift-and-merge
+ * steps instead of a loop on the bits of the mask.
+ * \ingroup detail
+ */
+class BitDeposit {
+public:
+    BitDeposit() = default;
+    explicit BitDeposit(uint64_t mask) : mask_{mask} {
+#ifndef __BMI2__
+        uint64_t remaining = mask;
+        uint64_t zerosOnRight = ~mask << 1;
+        for (size_t step = 0; step < 6; ++step) {
+            // parallel suffix: the bits having an odd number of zeros on their right
+            uint64_t odd = zerosOnRight ^ (zerosOnRight << 1);
+            odd ^= odd << 2;
+            odd ^= odd << 4;
+            odd ^= odd << 8;
+            odd ^= odd << 16;
+            odd ^= odd << 32;
+            moves_[step] = odd & remaining;
+            remaining = (remaining ^ moves_[step]) | (moves_[step] >> (size_t{1} << step));
+            zerosOnRight &= ~odd;
+        }
+#endif
+    }
+
+    /** \param value its bits above the population count of the mask are ignored */
+    uint64_t operator()(uint64_t value) const {
+#ifdef __BMI2__
+        return _pdep_u64(value, mask_);
+#else
+        value = (value & ~moves_[5]) | ((value << 32) & moves_[5]);
+        value = (value & ~moves_[4]) | ((value << 16) & moves_[4]);
+        value = (value & ~moves_[3]) | ((value << 8) & moves_[3]);
+        value = (value & ~moves_[2]) | ((value << 4) & moves_[2]);
+        value = (value & ~moves_[1]) | ((value << 2) & moves_[1]);
+        value = (value & ~moves_[0]) | ((value << 1) & moves_[0]);
+        return value & mask_;
+#endif
+    }
+
+private:
+    uint64_t mask_ = 0;
+#ifndef __BMI2__
+    uint64_t moves_[6] = {0, 0, 0, 0, 0, 0};
+        // the bits moved at each step, in their final position
+#endif
+};
+
+//***************************************************************************
+// mortonEncode, mortonDecode
+//***************************************************************************
+/** \brief Returns the Morton code (Z-order position) of a multi-index.
+ * Uses the BMI2 instructions if the code is compiled for them
+ * (e.g. `-mbmi2`), bit tricks otherwise.
+ * \ingroup morton
+ * \param index the multi-index, whose coordinates must fit in `64 / D` bits
+ */
+template <size_t dimensionality>
+uint64_t mortonEncode(const std::array<size_t, dimensionality>& index) {
+    uint64_t code = 0;
+    for (size_t d = 0; d < dimensionality; ++d) {
+        code |= mortonDeposit<dimensionality>(index[d], dimensionality - 1 - d);
+    }
+    return code;
+}
+
+/** \brief Returns the multi-index having the given Morton code,
+ * see mortonEncode
+ * \ingroup morton
+ */
+template <size_t dimensionality>
+std::array<size_t, dimensionality> mortonDecode(uint64_t code) {
+    std::array<size_t, dimensionality> index;
+    for (size_t d = 0; d < dimensionality; ++d) {
+        index[d] = static_cast<size_t>(mortonExtract<dimensionality>(code, dimensionality - 1 - d));
+    }
+    return index;
+}
+
+//***************************************************************************
+// mortonVisit
+//***************************************************************************
+// Calls visit(index) for the multi-indices within `bounds` of the block
+// of side `side` at `origin`, in Morton order. The block is divided in its
+// 2^D sub-blocks, the ones lying outside the bounds being skipped whole
+template <size_t dimensionality, typename Visitor>
+void mortonVisitBlock(
+    const std::array<size_t, dimensionality>& bounds,
+    std::array<size_t, dimensionality>& origin,
+    size_t side, Visitor& visit
+) {
+    for (size_t d = 0; d < dimensionality; ++d) {
+        if (origin[d] >= bounds[d]) return;
+    }
+    if (side == 1) {
+        visit(const_cast<const std::array<size_t, dimensionality>&>(origin));
+        return;
+    }
+
+    const size_t half = side / 2;
+    for (size_t child = 0; child < (size_t{1} << dimensionality); ++child) {
+        for (size_t d = 0; d < dimensionality; ++d) {
+            if ((child >> (dimensionality - 1 - d)) & 1) origin[d] += half;
+        }
+        mortonVisitBlock(bounds, origin, half, visit);
+        for (size_t d = 0; d < dimensionality; ++d) {
+            if ((child >> (dimensionality - 1 - d)) & 1) origin[d] -= half;
+        }
+    }
+}
+
+template <size_t dimensionality, typename Visitor>
+void mortonVisit(const std::array<size_t, dimensionality>& bounds, Visitor visit) {
+    size_t side = 1;
+    for (size_t d = 0; d < dimensionality; ++d) {
+        if (bounds[d] == 0) return;
+        while (side < bounds[d]) side *= 2;
+    }
+    std::array<size_t, dimensionality> origin;
+    origin.fill(0);
+    mortonVisitBlock(bounds, origin, side, visit);
+}
+
+//***************************************************************************
+// MultiIndexAccess
+//***************************************************************************
+/** \brief Provides the static member function `get`, which returns
+ * `range[index[level]][index[level + 1]]...`
+ * \ingroup detail
+ */
+template <size_t level, size_t dimensionality>
+struct MultiIndexAccess {
+    template <typename Range>
+    static auto get(Range&& range, const std::array<size_t, dimensionality>& index)
+        -> decltype(MultiIndexAccess<level + 1, dimensionality>::get(range[index[level]], index))
+    {
+        return MultiIndexAccess<level + 1, dimensionality>::get(range[index[level]], index);
+    }
+};
+
+template <size_t dimensionality>
+struct MultiIndexAccess<dimensionality, dimensionality> {
+    // returns proxies by value
+    template <typename Reference>
+    static Reference get(Reference&& reference, const std::array<size_t, dimensionality>&) {
+        return std::forward<Reference>(reference);
+    }
+};
+
+template <size_t dimensionality>
+std::array<size_t, dimensionality> toBoundsArray(const std::vector<size_t>& bounds) {
+    if (bounds.size() != dimensionality) {
+        throw std::runtime_error("Morton order : the bounds have the wrong dimensionality");
+    }
+    std::array<size_t, dimensionality> result;
+    std::copy_n(bounds.begin(), dimensionality, result.begin());
+    return result;
+}
+
+//***************************************************************************
+// forEachMorton
+//***************************************************************************
+/** \brief Calls `function(index, value)` for each element of a BoxedView,
+ * visiting them in Morton order (Z-order) instead of row-major order:
+ * each block of 2x2 (or 2x2x2...) elements is visited before the following
+ * one, then each block of 4x4, and so on, so that neighbouring elements
+ * are processed together.
+ * \ingroup morton
+ * \param view the BoxedView to be visited
+ * \param function called with the multi-index (as a `std::array<size_t, D>`)
+ *  and the element (possibly a proxy, which can be assigned to)
+ */
+template <template<typename> class ScalarPolicy, typename RawIterator, size_t dimensionality, typename Function>
+void forEachMorton(BoxedView<ScalarPolicy, RawIterator, dimensionality>& view, Function function) {
+    mortonVisit(
+        toBoundsArray<dimensionality>(view.viewBounds()),
+        [&](const std::array<size_t, dimensionality>& index) {
+            function(index, MultiIndexAccess<0, dimensionality>::get(view, index));
+        }
+    );
+}
+
+template <template<typename> class ScalarPolicy, typename RawIterator, size_t dimensionality, typename Function>
+void forEachMorton(const BoxedView<ScalarPolicy, RawIterator, dimensionality>& view, Function function) {
+    mortonVisit(
+        toBoundsArray<dimensionality>(view.viewBounds()),
+        [&](const std::array<size_t, dimensionality>& index) {
+            function(index, MultiIndexAccess<0, dimensionality>::get(view, index));
+        }
+    );
+}
+
+//***************************************************************************
+// MortonArray
+//***************************************************************************
+/** \brief A dense D-dimensional array storing its elements in Morton order,
+ * so that the elements which are close in all the dimensions
+ * are also close in memory.
+ * The bits which are zero for every multi-index within the bounds are
+ * removed from the Morton codes (this keeps their order), so that each
+ * dimension contributes only the bits of its own bound: the storage holds
+ * less than 2^D cells for each element, even for strongly non-square
+ * bounds (e.g. {100000, 3}); there are no unused cells when the bounds
+ * are powers of two.
+ * \param T the type of the elements
+ * \ingroup morton
+ */
+template <typename T, size_t dimensionality>
+class MortonArray {
+public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = size_t;
+    using Index = std::array<size_t, dimensionality>;
+
+    /** \param bounds the bounds of the array
+     * \param value the initial value of the elements
+     */
+    explicit MortonArray(const Index& bounds, const T& value = T{}) : bounds_(bounds) {
+        constexpr size_t bitsPerCoordinate = 64 / dimensionality;
+        size_t storageSize = 1;
+        for (size_t d = 0; d < dimensionality; ++d) {
+            if (bounds_[d] == 0) {
+                storageSize = 0;
+            } else if (bitsPerCoordinate < 64 && ((bounds_[d] - 1) >> (bitsPerCoordinate % 64)) != 0) {
+                throw std::runtime_error("MortonArray : bounds too large for a 64-bit Morton code");
+            }
+        }
+        if (storageSize != 0) {
+            Index last = bounds_;
+            size_t usedBits[dimensionality];
+            for (size_t d = 0; d < dimensionality; ++d) {
+                --last[d];
+                usedBits[d] = (last[d] == 0) ? 0 : (floorLog2(last[d]) + 1);
+            }
+            // Walk the bits of the Morton codes in order, keeping those used
+            // within the bounds: the i-th kept bit is the bit i of a position
+            uint64_t depositMasks[dimensionality] = {0};
+            size_t positionBit = 0;
+            for (size_t codeBit = 0; codeBit < bitsPerCoordinate * dimensionality; ++codeBit) {
+                const size_t d = dimensionality - 1 - codeBit % dimensionality;
+                if (codeBit / dimensionality < usedBits[d]) {
+                    depositMasks[d] |= uint64_t{1} << positionBit++;
+                }
+            }
+            for (size_t d = 0; d < dimensionality; ++d) deposits_[d] = BitDeposit{depositMasks[d]};
+            storageSize = position(last) + 1;
+        }
+        storage_.assign(storageSize, value);
+    }
+    /** \param bounds the bounds of the array, e.g. the result of `bounds(container)` */
+    explicit MortonArray(const std::vector<size_t>& bounds, const T& value = T{}) :
+        MortonArray{toBoundsArray<dimensionality>(bounds), value} {}
+
+    reference operator[](const Index& index) {return storage_[position(index)];}
+    const_reference operator[](const Index& index) const {return storage_[position(index)];}
+    reference at(const Index& index) {checkIndex(index); return (*this)[index];}
+    const_reference at(const Index& index) const {checkIndex(index); return (*this)[index];}
+
+    /** \brief The bounds of the array, see also `bounds(mortonArray)` */
+    const Index& arrayBounds() const {return bounds_;}
+    /** \brief The number of elements, i.e. the product of the bounds */
+    size_type size() const {
+        size_t result = 1;
+        for (size_t bound : bounds_) result *= bound;
+        return result;
+    }
+
+    /** \brief The position of an element in the storage: its Morton code,
+     * without the bits unused by the bounds. Each coordinate is deposited
+     * straight to its bits of the position */
+    size_t position(const Index& index) const {
+        uint64_t result = 0;
+        for (size_t d = 0; d < dimensionality; ++d) result |= deposits_[d](index[d]);
+        return static_cast<size_t>(result);
+    }
+
+    /** \brief The storage, in Morton order (including the unused cells) */
+    const std::vector<T>& storage() const {return storage_;}
+    std::vector<T>& storage() {return storage_;}
+
+    /** \brief Calls `function(index, value)` for each element, in Morton order,
+     * i.e. in the order of the storage */
+    template <typename Function>
+    void forEach(Function function) {
+        mortonVisit(bounds_, [&](const Index& index) {function(index, (*this)[index]);});
+    }
+    template <typename Function>
+    void forEach(Function function) const {
+        mortonVisit(bounds_, [&](const Index& index) {function(index, (*this)[index]);});
+    }
+
+private:
+    void checkIndex(const Index& index) const {
+        for (size_t d = 0; d < dimensionality; ++d) {
+            if (index[d] >= bounds_[d]) throw std::runtime_error("MortonArray: access out of bounds");
+        }
+    }
+
+private:
+    Index bounds_;
+    std::array<BitDeposit, dimensionality> deposits_;
+        // for each dimension, deposits a coordinate to its bits of the position
+    std::vector<T> storage_;
+};
+
+/** \brief The bounds of a MortonArray
+ * \ingroup morton
+ */
+template <typename T, size_t dimensionality>
+std::vector<size_t> bounds(const MortonArray<T, dimensionality>& array) {
+    return std::vector<size_t>(array.arrayBounds().begin(), array.arrayBounds().end());
+}
+
+//***************************************************************************
+// makeMortonArray
+//***************************************************************************
+/** \brief Copies a nested container in a MortonArray having its bounds,
+ * filling the missing elements with `defaultValue`.
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ * \param container the container to be copied
+ * \param defaultValue the value of the elements missing in the container
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void
+>
+auto makeMortonArray(
+    const Container& container,
+    typename IteratorScalarType<ScalarPolicy, decltype(begin(container))>::type defaultValue = {}
+)
+    -> MortonArray<
+        typename IteratorScalarType<ScalarPolicy, decltype(begin(container))>::type,
+        Dimensionality<ScalarPolicy, Container>::value
+       >
+{
+    using T = typename IteratorScalarType<ScalarPolicy, decltype(begin(container))>::type;
+    constexpr size_t dimensionality = Dimensionality<ScalarPolicy, Container>::value;
+
+    const auto view = makeBoxedView<ScalarPolicy>(container, defaultValue, {});
+    MortonArray<T, dimensionality> result{view.viewBounds(), defaultValue};
+    // The view is visited in Morton order, so the storage is written sequentially
+    forEachMorton(view, [&](const std::array<size_t, dimensionality>& index, const T& value) {
+        result[index] = value;
+    });
+    return result;
+}
+
+} // namespace multidim - Morton
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @KeyedView
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// IsKeyedContainer
+//***************************************************************************
+/** \brief Provides the `bool` member `value`, true if T is an associative
+ * container mapping keys to values (it has `key_type`, `mapped_type`
+ * and `find`), e.g. `std::map` or `std::unordered_map`
+ * \ingroup detail
+ */
+template <typename T>
+struct IsKeyedContainer {
+    template <typename T1 = T>
+    static constexpr auto isKeyed(int)
+    -> decltype(
+        std::declval<const T1&>().find(std::declval<const typename T1::key_type&>()),
+        std::declval<typename T1::mapped_type>(),
+        bool()
+    ) {
+        return true;
+    }
+
+    static constexpr auto isKeyed(long) -> decltype(bool()) {
+        return false;
+    }
+
+    static constexpr bool value = isKeyed(0);
+};
+
+/** \brief Provides the member typedef `type` as the type of the values
+ * stored in the innermost level of nested associative containers,
+ * and the `size_t` member `value` as their nesting level,
+ * e.g. `map<int, map<int, double>>` --> `type = double, value = 2`
+ * \ingroup detail
+ */
+template <typename Map, bool = IsKeyedContainer<typename Map::mapped_type>::value>
+struct KeyedLeaf;
+
+template <typename Map>
+struct KeyedLeaf<Map, false> {
+    using type = typename Map::mapped_type;
+    static constexpr size_t value = 1;
+};
+
+template <typename Map>
+struct KeyedLeaf<Map, true> {
+    using type = typename KeyedLeaf<typename Map::mapped_type>::type;
+    static constexpr size_t value = 1 + KeyedLeaf<typename Map::mapped_type>::value;
+};
+
+/** \brief Provides the member constant `value`, which is `true` if all the
+ * levels of nested associative containers have the same `key_type`
+ * \ingroup detail
+ */
+template <typename Map, bool = IsKeyedContainer<typename Map::mapped_type>::value>
+struct KeyedSameKeys : std::true_type {};
+
+template <typename Map>
+struct KeyedSameKeys<Map, true> : std::integral_constant<bool,
+       std::is_same<typename Map::key_type, typename Map::mapped_type::key_type>::value
+    && KeyedSameKeys<typename Map::mapped_type>::value
+> {};
+
+//***************************************************************************
+// keyedVisit, accumulateKeyBounds
+//***************************************************************************
+// Version for the innermost level
+template <typename Map, typename Key, size_t dimensionality, typename Function>
+void keyedVisit(
+    const Map& map, std::array<Key, dimensionality>& keys, size_t level,
+    Function& function, std::false_type
+) {
+    for (const auto& entry : map) {
+        keys[level] = entry.first;
+        function(const_cast<const std::array<Key, dimensionality>&>(keys), entry.second);
+    }
+}
+
+// Version for the outer levels
+template <typename Map, typename Key, size_t dimensionality, typename Function>
+void keyedVisit(
+    const Map& map, std::array<Key, dimensionality>& keys, size_t level,
+    Function& function, std::true_type
+) {
+    using SubMap = typename Map::mapped_type;
+    for (const auto& entry : map) {
+        keys[level] = entry.first;
+        keyedVisit(
+            entry.second, keys, level + 1, function,
+            std::integral_constant<bool, IsKeyedContainer<typename SubMap::mapped_type>::value>{}
+        );
+    }
+}
+
+// bounds[level] = 1 + the largest key of the level
+template <typename Map>
+void accumulateKeyBounds(const Map& map, size_t level, std::vector<size_t>& bounds, std::false_type) {
+    using Key = typename Map::key_type;
+    static_assert(std::is_integral<Key>::value, "bounds : the keys must be integers");
+    for (const auto& entry : map) {
+        if (std::is_signed<Key>::value && entry.first < Key{}) {
+            throw std::runtime_error("bounds : negative key");
+        }
+        bounds[level] = std::max(bounds[level], static_cast<size_t>(entry.first) + 1);
+    }
+}
+
+template <typename Map>
+void accumulateKeyBounds(const Map& map, size_t level, std::vector<size_t>& bounds, std::true_type) {
+    using SubMap = typename Map::mapped_type;
+    accumulateKeyBounds(map, level, bounds, std::false_type{});
+    for (const auto& entry : map) {
+        accumulateKeyBounds(
+            entry.second, level + 1, bounds,
+            std::integral_constant<bool, IsKeyedContainer<typename SubMap::mapped_type>::value>{}
+        );
+    }
+}
+
+//***************************************************************************
+// KeyedRange
+//***************************************************************************
+/** \brief A (sub)range of a KeyedView, i.e. a read-only view of
+ * an associative container, whose square brackets look up a key
+ * and return the default value if it is missing.
+ * Its iterators are those of the container, so a traversal visits
+ * only the keys which are present.
+ * \param Map the associative container, e.g. `std::map<int, std::map<int, double>>`
+ * \param T the type of the values in the innermost level
+ * \ingroup keyed_view
+ */
+template <typename Map, typename T>
+class KeyedRange {
+    static constexpr bool isLeaf = !IsKeyedContainer<typename Map::mapped_type>::value;
+
+public:
+    using key_type = typename Map::key_type;
+    using mapped_type = typename Map::mapped_type;
+    using value_type = typename Map::value_type;
+    using const_iterator = typename Map::const_iterator;
+    using iterator = const_iterator;
+    using size_type = size_t;
+    using ScalarType = T;
+    /** \brief The type returned by `operator[]`: a KeyedRange on the
+     * following level, or a reference to a value in the innermost one */
+    using reference = typename std::conditional<
+        isLeaf, const T&, KeyedRange<mapped_type, T>
+    >::type;
+
+    static constexpr size_t dimensionality = KeyedLeaf<Map>::value;
+
+    /** \param map the container
+     * \param defaultValue the value returned for the missing keys,
+     *  which must outlive the range
+     */
+    KeyedRange(const Map& map, const T& defaultValue) :
+        map_{&map}, defaultValue_{&defaultValue} {}
+
+    /** \brief Looks up `key`: O(log n) for ordered containers,
+     * O(1) on average for hashed ones.
+     * If the key is missing, returns the default value
+     * (or, in outer levels, an empty range)
+     */
+    reference operator[](const key_type& key) const {
+        return lookup(key, std::integral_constant<bool, isLeaf>{});
+    }
+    /** \brief Whether `key` is present */
+    bool contains(const key_type& key) const {return map_->find(key) != map_->end();}
+
+    const_iterator begin() const {return map_->begin();}
+    const_iterator end() const {return map_->end();}
+    const_iterator cbegin() const {return map_->begin();}
+    const_iterator cend() const {return map_->end();}
+
+    /** \brief The number of keys present (not the bounds) */
+    size_type size() const {return map_->size();}
+    bool empty() const {return map_->empty();}
+
+    /** \brief The underlying container */
+    const Map& base() const {return *map_;}
+    /** \brief The value returned for the missing keys */
+    const T& defaultValue() const {return *defaultValue_;}
+
+    /** \brief Calls `function(keys, value)` for each value in the innermost
+     * level, visiting only the keys which are present.
+     * `keys` is a `std::array` holding the key of each level,
+     * so all the levels must have the same key type.
+     */
+    template <typename Function>
+    void forEach(Function function) const {
+        static_assert(
+            KeyedSameKeys<Map>::value,
+            "KeyedRange::forEach : all the levels must have the same key type"
+        );
+        std::array<key_type, dimensionality> keys;
+        keyedVisit(*map_, keys, 0, function, std::integral_constant<bool, !isLeaf>{});
+    }
+
+    /** \brief The bounds of the range, for integer keys: in each level,
+     * 1 + the largest key present (0 if there are none).
+     * The same result as `bounds(range)`.
+     */
+    std::vector<size_t> viewBounds() const {
+        std::vector<size_t> result(dimensionality, 0);
+        accumulateKeyBounds(*map_, 0, result, std::integral_constant<bool, !isLeaf>{});
+        return result;
+    }
+
+private:
+    const T& lookup(const key_type& key, std::true_type) const {
+        const auto found = map_->find(key);
+        return (found == map_->end()) ? *defaultValue_ : found->second;
+    }
+    KeyedRange<mapped_type, T> lookup(const key_type& key, std::false_type) const {
+        const auto found = map_->find(key);
+        return KeyedRange<mapped_type, T>{
+            (found == map_->end()) ? emptyMapped() : found->second,
+            *defaultValue_
+        };
+    }
+
+    // The container shown for a missing key in outer levels
+    static const mapped_type& emptyMapped() {
+        static const mapped_type empty{};
+        return empty;
+    }
+
+protected:
+    const Map* map_;
+    const T* defaultValue_;
+};
+
+template <typename Map, typename T>
+constexpr size_t KeyedRange<Map, T>::dimensionality;
+
+//***************************************************************************
+// KeyedView
+//***************************************************************************
+/** \brief A View of a (possibly nested) associative container, e.g.
+ * `std::map<int, std::unordered_map<int, double>>`, in which
+ * `view[i][j]` looks up the keys `i` and `j`, returning a default value
+ * if one is missing, i.e. the counterpart of BoxedView for sparse data.
+ * It owns its default value, so its subranges remain valid
+ * as long as the View and the container.
+ * See KeyedRange for the members.
+ * \ingroup keyed_view
+ */
+template <typename Map, typename T = typename KeyedLeaf<Map>::type>
+class KeyedView : public KeyedRange<Map, T> {
+public:
+    /** \param map the container
+     * \param defaultValue the value returned for the missing keys
+     */
+    explicit KeyedView(const Map& map, T defaultValue = T{}) :
+        KeyedView{map, std::make_shared<T>(std::move(defaultValue))} {}
+
+private:
+    KeyedView(const Map& map, std::shared_ptr<const T> defaultValue) :
+        KeyedRange<Map, T>{map, *defaultValue},
+        ownedDefault_{std::move(defaultValue)} {}
+
+private:
+    std::shared_ptr<const T> ownedDefault_;
+};
+
+/** \brief The bounds of a KeyedRange, i.e. 1 + the largest key
+ * in each level, see `KeyedRange::viewBounds`
+ * \ingroup keyed_view
+ */
+template <typename Map, typename T>
+std::vector<size_t> bounds(const KeyedRange<Map, T>& range) {
+    return range.viewBounds();
+}
+
+template <typename Map, typename T>
+std::vector<size_t> bounds(const KeyedView<Map, T>& view) {
+    return view.viewBounds();
+}
+
+//***************************************************************************
+// makeKeyedView
+//***************************************************************************
+/** \brief Factory method to build a KeyedView of a (possibly nested)
+ * associative container
+ * \ingroup user_functions
+ * \param container the container, e.g. a `std::map<int, std::map<int, double>>`
+ * \param defaultValue the value of the elements whose keys are missing
+ */
+template <typename Map>
+KeyedView<Map> makeKeyedView(
+    const Map& container,
+    typename KeyedLeaf<Map>::type defaultValue = typename KeyedLeaf<Map>::type{}
+) {
+    static_assert(
+        IsKeyedContainer<Map>::value,
+        "makeKeyedView : the container must be an associative container"
+    );
+    return KeyedView<Map>{container, std::move(defaultValue)};
+}
+
+} // namespace multidim - KeyedView
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @SparseArray
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+// **************************************************************************
+// forward declarations
+template <typename T, size_t dimensionality>
+class SparseArray;
+
+/** \brief Proxy class representing a reference to a cell of a SparseArray:
+ * reading returns the stored value or the default one, writing stores
+ * the value (or erases the cell, if it is the default value).
+ * Plays the same role as BoxedViewScalarProxy.
+ * \ingroup sparse_array
+ */
+template <typename Array>
+class SparseScalarProxy {
+public:
+    using ScalarType = typename Array::value_type;
+
+    SparseScalarProxy(Array* array, uint64_t key) : array_{array}, key_{key} {}
+    SparseScalarProxy(const SparseScalarProxy&) = default;
+
+    operator const ScalarType&() const {return array_->getKey(key_);}
+    SparseScalarProxy& operator=(const ScalarType& value) {
+        array_->setKey(key_, value);
+        return *this;
+    }
+    SparseScalarProxy& operator=(const SparseScalarProxy& other) {
+        return (*this = static_cast<const ScalarType&>(other));
+    }
+
+private:
+    Array* array_;
+    uint64_t key_;
+};
+
+// The type of a cell of a const SparseArray is a plain const reference
+template <typename Array>
+struct SparseScalarReference {
+    using type = SparseScalarProxy<Array>;
+    static type make(Array* array, uint64_t key) {return type{array, key};}
+};
+
+template <typename Array>
+struct SparseScalarReference<const Array> {
+    using type = const typename Array::value_type&;
+    static type make(const Array* array, uint64_t key) {return array->getKey(key);}
+};
+
+template <typename Array, size_t dimensionality>
+class SparseRange;
+
+//***************************************************************************
+// SparseIterator
+//***************************************************************************
+/** \brief The iterator used in SparseArray and its subranges.
+ * It is proxied, like the iterators of BoxedView: it points to
+ * the subranges (or, in the innermost level, to the cells) of a range,
+ * identified by their packed coordinates.
+ * \param Array the SparseArray, const-qualified for const iterators
+ * \param elementDimensionality the dimensionality of the pointed elements
+ *  (0 for cells)
+ * \ingroup sparse_array
+ */
+template <typename Array, size_t elementDimensionality>
+class SparseIterator {
+    using Element = typename std::conditional<
+        elementDimensionality == 0,
+        SparseScalarReference<Array>,
+        SparseRange<Array, elementDimensionality>
+    >::type;
+
+public:
+    // [iterator.traits]
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename std::conditional<
+        elementDimensionality == 0,
+        typename Array::value_type,
+        SparseRange<Array, elementDimensionality>
+    >::type;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type*;
+    using reference = typename std::conditional<
+        elementDimensionality == 0,
+        typename SparseScalarReference<Array>::type,
+        SparseRange<Array, elementDimensionality>
+    >::type;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    SparseIterator() : array_{nullptr}, key_{0}, index_{0} {}
+    /* \brief Default constructor. */
+
+    /** \param array the SparseArray
+     * \param key the packed coordinates of the first element of the range
+     * \param index the index of the pointed element in the range
+     */
+    SparseIterator(Array* array, uint64_t key, size_t index) :
+        array_{array}, key_{key}, index_{index} {}
+
+    SparseIterator(const SparseIterator&) = default;
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    // [iterator.iterators]
+    reference operator*() const {
+        return Element::make(array_, key_ + index_ * array_->stride(Array::dimensionality - 1 - elementDimensionality));
+    }
+    SparseIterator& operator++() {++index_; return *this;}
+
+    // [input.iterators] and [output.iterators]
+    bool operator==(const SparseIterator& other) const {return index_ == other.index_;}
+    bool operator!=(const SparseIterator& other) const {return !((*this) == other);}
+    SparseIterator operator++(int) {auto tmp = *this; ++(*this); return tmp;}
+
+    // [bidirectional.iterators]
+    SparseIterator& operator--() {--index_; return *this;}
+    SparseIterator operator--(int) {auto other = *this; --(*this); return other;}
+
+    // [random.access.iterators]
+    SparseIterator& operator+=(difference_type n) {index_ += n; return *this;}
+    SparseIterator operator+(difference_type n) const {auto result = (*this); result += n; return result;}
+    friend SparseIterator operator+(difference_type n, const SparseIterator& other) {return other + n;}
+    SparseIterator& operator-=(difference_type n) {return (*this += (-n));}
+    SparseIterator operator-(difference_type n) const {return (*this + (-n));}
+
+    difference_type operator-(const SparseIterator& other) const {
+        return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+    bool operator<(const SparseIterator& other) const {return index_ < other.index_;}
+    bool operator>(const SparseIterator& other) const {return index_ > other.index_;}
+    bool operator>=(const SparseIterator& other) const {return !((*this) < other);}
+    bool operator<=(const SparseIterator& other) const {return !((*this) > other);}
+
+    reference operator[](difference_type n) const {return *(*this + n);}
+
+private: // members
+    Array* array_;
+    uint64_t key_;
+    size_t index_;
+};
+
+//***************************************************************************
+// SparseRange
+//***************************************************************************
+/** \brief A subrange of a SparseArray, e.g. `array[i]` (whose elements
+ * are `array[i][j]`...), showing its logical box
+ * \ingroup sparse_array
+ */
+template <typename Array, size_t dimensionality>
+class SparseRange {
+public:
+    using iterator = SparseIterator<Array, dimensionality - 1>;
+    using const_iterator = iterator;
+        // constness is determined by Array
+    using value_type = typename iterator::value_type;
+    using reference = typename iterator::reference;
+    using const_reference = reference;
+    using difference_type = ptrdiff_t;
+    using size_type = size_t;
+
+    SparseRange() : array_{nullptr}, key_{0} {}
+    SparseRange(Array* array, uint64_t key) : array_{array}, key_{key} {}
+    static SparseRange make(Array* array, uint64_t key) {return SparseRange{array, key};}
+
+    iterator begin() const {return iterator{array_, key_, 0};}
+    const_iterator cbegin() const {return begin();}
+    iterator end() const {return iterator{array_, key_, size()};}
+    const_iterator cend() const {return end();}
+
+    reference operator[](size_type n) const {return begin()[static_cast<difference_type>(n)];}
+    size_type size() const {
+        return array_->arrayBounds()[Array::dimensionality - dimensionality];
+    }
+    bool empty() const {return (size() == 0);}
+
+private:
+    Array* array_;
+    uint64_t key_;
+};
+
+//***************************************************************************
+// SparseArray
+//***************************************************************************
+/** \brief A sparse D-dimensional array, i.e. a logical box of cells
+ * holding a default value, of which only the other ones are stored.
+ * The cells are kept in an open-addressing hash table (linear probing)
+ * whose keys are the row-major positions of the cells in the box,
+ * so boxes of up to 2^64 - 1 cells can be represented.
+ * Like a BoxedView, it can be accessed with square brackets
+ * (`array[i][j][k]`, through proxies) and iterated as a nested range of
+ * the whole box; `forEachStored` and `toCoo` visit only the stored cells.
+ * \param T the type of the cells, which must be equality-comparable
+ * \ingroup sparse_array
+ */
+template <typename T, size_t dimensionality_>
+class SparseArray {
+    static_assert(dimensionality_ > 0, "SparseArray : the dimensionality must be > 0");
+
+public:
+    using iterator = SparseIterator<SparseArray, dimensionality_ - 1>;
+    using const_iterator = SparseIterator<const SparseArray, dimensionality_ - 1>;
+    using value_type = T;
+    using reference = typename iterator::reference;
+    using const_reference = typename const_iterator::reference;
+    using difference_type = ptrdiff_t;
+    using size_type = size_t;
+    using Index = std::array<size_t, dimensionality_>;
+
+    static constexpr size_t dimensionality = dimensionality_;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    /** \param bounds the logical box
+     * \param defaultValue the value of the cells which are not stored
+     */
+    explicit SparseArray(const Index& bounds, T defaultValue = T{}) :
+        bounds_(bounds), defaultValue_(std::move(defaultValue)), storedSize_{0}
+    {
+        uint64_t stride = 1;
+        for (size_t d = dimensionality_; d-- > 0; ) {
+            strides_[d] = stride;
+            if (bounds_[d] != 0 && stride > (emptyKey - 1) / bounds_[d]) {
+                throw std::runtime_error("SparseArray : the box is too large for 64-bit keys");
+            }
+            stride *= bounds_[d];
+        }
+        logicalSize_ = stride;
+    }
+    /** \param bounds the logical box, e.g. the result of `bounds(container)` */
+    explicit SparseArray(const std::vector<size_t>& bounds, T defaultValue = T{}) :
+        SparseArray{toBoundsArray<dimensionality_>(bounds), std::move(defaultValue)} {}
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    iterator begin() {return iterator{this, 0, 0};}
+    const_iterator begin() const {return const_iterator{this, 0, 0};}
+    const_iterator cbegin() const {return begin();}
+    iterator end() {return iterator{this, 0, size()};}
+    const_iterator end() const {return const_iterator{this, 0, size()};}
+    const_iterator cend() const {return end();}
+
+    reference operator[](size_type n) {return begin()[static_cast<difference_type>(n)];}
+    const_reference operator[](size_type n) const {return begin()[static_cast<difference_type>(n)];}
+
+    /** \brief The apparent size of the outermost dimension */
+    size_type size() const {return bounds_[0];}
+    bool empty() const {return (size() == 0);}
+
+    // **************************************************************************
+    // Cell access
+    // **************************************************************************
+    /** \brief The value of a cell: the stored one, or the default one */
+    const T& get(const Index& index) const {return getKey(packIndex(index));}
+    /** \brief Stores the value of a cell, or erases it if `value`
+     * is the default value */
+    void set(const Index& index, const T& value) {setKey(packIndex(index), value);}
+    /** \brief Whether a cell is stored */
+    bool contains(const Index& index) const {return findSlot(packIndex(index)) != NO_VALUE;}
+
+    /** \brief The logical box */
+    const Index& arrayBounds() const {return bounds_;}
+    /** \brief The number of cells in the logical box */
+    uint64_t logicalSize() const {return logicalSize_;}
+    /** \brief The number of stored cells */
+    size_t storedSize() const {return storedSize_;}
+    const T& defaultValue() const {return defaultValue_;}
+
+    /** \brief Prepares the table for `cellCount` stored cells */
+    void reserve(size_t cellCount) {
+        size_t capacity = minCapacity;
+        while (capacity * maxLoadNumerator < cellCount * maxLoadDenominator) capacity *= 2;
+        if (capacity > slots_.size()) rehash(capacity);
+    }
+    /** \brief Erases all the stored cells */
+    void clear() {
+        slots_.clear();
+        storedSize_ = 0;
+    }
+
+    /** \brief Calls `function(index, value)` for each stored cell,
+     * in no particular order */
+    template <typename Function>
+    void forEachStored(Function function) const {
+        for (const auto& slot : slots_) {
+            if (slot.key != emptyKey) {
+                const Index index = unpackKey(slot.key);
+                function(index, slot.value);
+            }
+        }
+    }
+
+    /** \brief Returns the stored cells in coordinate (COO) format,
+     * in row-major order, see `BoxedView::toCoo` */
+    CooData<T, dimensionality_> toCoo() const {
+        std::vector<const Slot*> stored;
+        stored.reserve(storedSize_);
+        for (const auto& slot : slots_) {
+            if (slot.key != emptyKey) stored.push_back(&slot);
+        }
+        std::sort(stored.begin(), stored.end(), [](const Slot* a, const Slot* b) {
+            return a->key < b->key;
+        });
+
+        CooData<T, dimensionality_> result;
+        result.resize(stored.size());
+        for (size_t n = 0; n < stored.size(); ++n) {
+            const auto index = unpackKey(stored[n]->key);
+            for (size_t d = 0; d < dimensionality_; ++d) result.indices[d][n] = index[d];
+            result.values[n] = stored[n]->value;
+        }
+        return result;
+    }
+
+    // **************************************************************************
+    // Packed coordinates (used by the iterators and the proxies)
+    // **************************************************************************
+    /** \brief The distance between consecutive cells of dimension `d`,
+     * in row-major positions */
+    uint64_t stride(size_t d) const {return strides_[d];}
+
+    const T& getKey(uint64_t key) const {
+        const size_t slot = findSlot(key);
+        return (slot == NO_VALUE) ? defaultValue_ : slots_[slot].value;
+    }
+    void setKey(uint64_t key, const T& value) {
+        if (value == defaultValue_) {
+            eraseKey(key);
+            return;
+        }
+        const size_t found = findSlot(key);
+        if (found != NO_VALUE) {
+            slots_[found].value = value;
+            return;
+        }
+        if ((storedSize_ + 1) * maxLoadDenominator > slots_.size() * maxLoadNumerator) {
+            // `value` may be a cell of this array (e.g. s.set(i, s.get(j))),
+            // which the rehash would free
+            T copy{value};
+            rehash(std::max(minCapacity, slots_.size() * 2));
+            insertNew(key, std::move(copy));
+            return;
+        }
+        insertNew(key, value);
+    }
+
+private:
+    struct Slot {
+        uint64_t key;
+        T value;
+    };
+
+    static constexpr uint64_t emptyKey = std::numeric_limits<uint64_t>::max();
+    static constexpr size_t minCapacity = 16;
+    static constexpr size_t maxLoadNumerator = 3;     // load factor <= 3/4
+    static constexpr size_t maxLoadDenominator = 4;
+
+    uint64_t packIndex(const Index& index) const {
+        uint64_t key = 0;
+        for (size_t d = 0; d < dimensionality_; ++d) {
+            if (index[d] >= bounds_[d]) throw std::runtime_error("SparseArray : access out of bounds");
+            key += index[d] * strides_[d];
+        }
+        return key;
+    }
+    Index unpackKey(uint64_t key) const {
+        Index index;
+        for (size_t d = 0; d < dimensionality_; ++d) {
+            index[d] = static_cast<size_t>(key / strides_[d]);
+            key %= strides_[d];
+        }
+        return index;
+    }
+
+    // Fibonacci hashing: the high bits of the product are well mixed
+    size_t homeSlot(uint64_t key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    size_t findSlot(uint64_t key) const {
+        if (slots_.empty()) return NO_VALUE;
+        const size_t mask = slots_.size() - 1;
+        for (size_t slot = homeSlot(key); ; slot = (slot + 1) & mask) {
+            if (slots_[slot].key == key) return slot;
+            if (slots_[slot].key == emptyKey) return NO_VALUE;
+        }
+    }
+
+    void insertNew(uint64_t key, T value) {
+        const size_t mask = slots_.size() - 1;
+        size_t slot = homeSlot(key);
+        while (slots_[slot].key != emptyKey) slot = (slot + 1) & mask;
+        slots_[slot].key = key;
+        slots_[slot].value = std::move(value);
+        ++storedSize_;
+    }
+
+    // Backward-shift deletion: no tombstones, so lookups stay short
+    void eraseKey(uint64_t key) {
+        size_t hole = findSlot(key);
+        if (hole == NO_VALUE) return;
+        const size_t mask = slots_.size() - 1;
+        for (size_t slot = (hole + 1) & mask; slots_[slot].key != emptyKey; slot = (slot + 1) & mask) {
+            // The cell can fill the hole if its home slot is not in (hole, slot]
+            if (((slot - homeSlot(slots_[slot].key)) & mask) >= ((slot - hole) & mask)) {
+                slots_[hole] = std::move(slots_[slot]);
+                hole = slot;
+            }
+        }
+        slots_[hole].key = emptyKey;
+        slots_[hole].value = defaultValue_;
+        --storedSize_;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> oldSlots(capacity, Slot{emptyKey, defaultValue_});
+        oldSlots.swap(slots_);
+        shift_ = 64 - static_cast<unsigned>(countTrailingZeros(capacity));
+        storedSize_ = 0;
+        for (auto& slot : oldSlots) {
+            if (slot.key != emptyKey) insertNew(slot.key, std::move(slot.value));
+        }
+    }
+
+private:
+    Index bounds_;
+    Index strides_;
+    uint64_t logicalSize_;
+    T defaultValue_;
+    std::vector<Slot> slots_;
+    size_t storedSize_;
+    unsigned shift_ = 64;
+};
+
+template <typename T, size_t dimensionality_>
+constexpr size_t SparseArray<T, dimensionality_>::dimensionality;
+template <typename T, size_t dimensionality_>
+constexpr uint64_t SparseArray<T, dimensionality_>::emptyKey;
+template <typename T, size_t dimensionality_>
+constexpr size_t SparseArray<T, dimensionality_>::minCapacity;
+
+/** \brief The bounds of a SparseArray, i.e. its logical box
+ * \ingroup sparse_array
+ */
+template <typename T, size_t dimensionality>
+std::vector<size_t> bounds(const SparseArray<T, dimensionality>& array) {
+    return std::vector<size_t>(array.arrayBounds().begin(), array.arrayBounds().end());
+}
+
+/** \brief Which cells of a SparseArray `scalarSize` counts
+ * \ingroup sparse_array
+ */
+enum class SparseCells {
+    logical,    /**< all the cells of the logical box */
+    stored      /**< only the stored cells */
+};
+
+/** \brief The number of cells of a SparseArray: by default, the logical
+ * ones, as for the other nested ranges
+ * \ingroup sparse_array
+ */
+template <typename T, size_t dimensionality>
+uint64_t scalarSize(const SparseArray<T, dimensionality>& array, SparseCells cells = SparseCells::logical) {
+    return (cells == SparseCells::logical) ? array.logicalSize() : array.storedSize();
+}
+
+//***************************************************************************
+// makeSparseArray
+//***************************************************************************
+/** \brief Factory method to build an empty SparseArray
+ * \ingroup user_functions
+ * \param bounds the logical box, e.g. `std::array<size_t, 3>{{10000, 10000, 10000}}`
+ * \param defaultValue the value of the cells which are not stored
+ */
+template <typename T, size_t dimensionality>
+SparseArray<T, dimensionality> makeSparseArray(
+    const std::array<size_t, dimensionality>& bounds, T defaultValue = T{}
+) {
+    return SparseArray<T, dimensionality>{bounds, std::move(defaultValue)};
+}
+
+} // namespace multidim - SparseArray
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @CowContainer
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// CowNode
+//***************************************************************************
+// The rows of a CowContainer are the leaves of a trie with 32-way nodes.
+// Each node and row records the epoch (i.e. the number of snapshots taken
+// before it) in which it was created: the writer modifies in place only
+// the ones of the current epoch, and clones the others, which may be
+// shared with snapshots.
+constexpr size_t cowShift = 5;
+constexpr size_t cowBranching = size_t{1} << cowShift;
+
+template <typename Row>
+struct CowRowNode {
+    uint64_t epoch;
+    Row row;
+};
+
+template <typename Row>
+struct CowNode {
+    uint64_t epoch;
+    std::vector<std::shared_ptr<CowNode>> children;         // inner nodes
+    std::vector<std::shared_ptr<CowRowNode<Row>>> rows;     // leaves
+};
+
+// The node holding row `index`, in a trie of `depth` levels
+template <typename Row>
+const CowNode<Row>* cowFindLeaf(const CowNode<Row>* node, size_t depth, size_t index) {
+    for (size_t level = depth - 1; level > 0; --level) {
+        node = node->children[(index >> (cowShift * level)) & (cowBranching - 1)].get();
+    }
+    return node;
+}
+
+//***************************************************************************
+// CowIterator
+//***************************************************************************
+/** \brief The iterator of a CowSnapshot: a random access iterator
+ * on its (const) rows. It caches the leaf of the trie holding
+ * the current row, so the rows of a leaf are visited in constant time.
+ * \ingroup cow_container
+ */
+template <typename Row>
+class CowIterator {
+public:
+    // [iterator.traits]
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Row;
+    using difference_type = ptrdiff_t;
+    using pointer = const Row*;
+    using reference = const Row&;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    CowIterator() : root_{nullptr}, depth_{0}, index_{0}, leaf_{nullptr}, leafFirst_{0} {}
+    /* \brief Default constructor. */
+
+    CowIterator(const CowNode<Row>* root, size_t depth, size_t index) :
+        root_{root}, depth_{depth}, index_{index}, leaf_{nullptr}, leafFirst_{0} {}
+
+    CowIterator(const CowIterator&) = default;
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    // [iterator.iterators]
+    reference operator*() const {
+        if (leaf_ == nullptr || index_ - leafFirst_ >= cowBranching) {
+            leaf_ = cowFindLeaf(root_, depth_, index_);
+            leafFirst_ = index_ & ~(cowBranching - 1);
+        }
+        return leaf_->rows[index_ - leafFirst_]->row;
+    }
+    pointer operator->() const {return &**this;}
+    CowIterator& operator++() {++index_; return *this;}
+
+    // [input.iterators] and [output.iterators]
+    bool operator==(const CowIterator& other) const {return index_ == other.index_;}
+    bool operator!=(const CowIterator& other) const {return !((*this) == other);}
+    CowIterator operator++(int) {auto tmp = *this; ++(*this); return tmp;}
+
+    // [bidirectional.iterators]
+    CowIterator& operator--() {--index_; return *this;}
+    CowIterator operator--(int) {auto other = *this; --(*this); return other;}
+
+    // [random.access.iterators]
+    CowIterator& operator+=(difference_type n) {index_ += n; return *this;}
+    CowIterator operator+(difference_type n) const {auto result = (*this); result += n; return result;}
+    friend CowIterator operator+(difference_type n, const CowIterator& other) {return other + n;}
+    CowIterator& operator-=(difference_type n) {return (*this += (-n));}
+    CowIterator operator-(difference_type n) const {return (*this + (-n));}
+
+    difference_type operator-(const CowIterator& other) const {
+        return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+    bool operator<(const CowIterator& other) const {return index_ < other.index_;}
+    bool operator>(const CowIterator& other) const {return index_ > other.index_;}
+    bool operator>=(const CowIterator& other) const {return !((*this) < other);}
+    bool operator<=(const CowIterator& other) const {return !((*this) > other);}
+
+    reference operator[](difference_type n) const {return *(*this + n);}
+
+private: // members
+    const CowNode<Row>* root_;
+    size_t depth_;
+    size_t index_;
+    mutable const CowNode<Row>* leaf_;  // cache
+    mutable size_t leafFirst_;
+};
+
+//***************************************************************************
+// CowSnapshot
+//***************************************************************************
+/** \brief An immutable version of a CowContainer, i.e. a range of
+ * const rows which can be read (e.g. through a FlatView or a BoxedView)
+ * while the container keeps being modified.
+ * Copying it is cheap: it only shares the rows.
+ * \ingroup cow_container
+ */
+template <typename Row>
+class CowSnapshot {
+public:
+    using iterator = CowIterator<Row>;
+    using const_iterator = iterator;
+    using value_type = Row;
+    using reference = const Row&;
+    using const_reference = reference;
+    using difference_type = ptrdiff_t;
+    using size_type = size_t;
+
+    CowSnapshot() : depth_{0}, size_{0} {}
+    CowSnapshot(std::shared_ptr<const CowNode<Row>> root, size_t depth, size_t size) :
+        root_{std::move(root)}, depth_{depth}, size_{size} {}
+
+    iterator begin() const {return iterator{root_.get(), depth_, 0};}
+    const_iterator cbegin() const {return begin();}
+    iterator end() const {return iterator{root_.get(), depth_, size_};}
+    const_iterator cend() const {return end();}
+
+    reference operator[](size_type n) const {
+        return cowFindLeaf(root_.get(), depth_, n)->rows[n & (cowBranching - 1)]->row;
+    }
+    reference at(size_type n) const {
+        if (n >= size_) throw std::runtime_error("CowSnapshot::at : access out of bounds");
+        return (*this)[n];
+    }
+    size_type size() const {return size_;}
+    bool empty() const {return (size() == 0);}
+
+private:
+    std::shared_ptr<const CowNode<Row>> root_;
+    size_t depth_;
+    size_t size_;
+};
+
+//***************************************************************************
+// CowContainer
+//***************************************************************************
+/** \brief A container of rows (e.g. a `CowContainer<std::vector<int>>`,
+ * the copy-on-write counterpart of a `std::vector<std::vector<int>>`)
+ * for a writer modifying it while readers iterate over its snapshots.
+ * The rows are reference-counted and shared with the snapshots:
+ * `snapshot()` takes constant time, and the first modification of a row
+ * after a snapshot clones only that row (plus O(log(size)) pointers),
+ * so the cost of a snapshot is proportional to the rows touched afterwards.
+ * \note Only the snapshots can be shared among threads: the container
+ *  itself, including `snapshot()`, must be used by one thread at a time
+ *  (e.g. the writer takes the snapshots and hands them to the readers).
+ * \ingroup cow_container
+ */
+template <typename Row>
+class CowContainer {
+public:
+    using value_type = Row;
+    using size_type = size_t;
+    using Snapshot = CowSnapshot<Row>;
+
+    CowContainer() : epoch_{0}, depth_{1}, size_{0}, root_{newNode()} {}
+    /** \param rows the initial rows */
+    explicit CowContainer(std::vector<Row> rows) : CowContainer{} {
+        for (auto& row : rows) pushBack(std::move(row));
+    }
+    /** \brief Copies the container in constant time, like `snapshot()`:
+     * the two containers share their rows, which both of them will clone
+     * before modifying them */
+    CowContainer(const CowContainer& other) :
+        epoch_{++other.epoch_},     // freezes the shared nodes in both
+        depth_{other.depth_}, size_{other.size_}, root_{other.root_} {}
+    CowContainer& operator=(const CowContainer& other) {
+        CowContainer copy{other};
+        std::swap(epoch_, copy.epoch_);
+        std::swap(depth_, copy.depth_);
+        std::swap(size_, copy.size_);
+        std::swap(root_, copy.root_);
+        return *this;
+    }
+
+    /** \brief Returns a row for reading */
+    const Row& operator[](size_type n) const {
+        return cowFindLeaf<Row>(root_.get(), depth_, n)->rows[n & (cowBranching - 1)]->row;
+    }
+    const Row& at(size_type n) const {
+        if (n >= size_) throw std::runtime_error("CowContainer::at : access out of bounds");
+        return (*this)[n];
+    }
+    /** \brief Returns a row for writing, cloning it first if it is shared
+     * with a snapshot. The reference is valid until the next snapshot. */
+    Row& mutableRow(size_type n) {
+        if (n >= size_) throw std::runtime_error("CowContainer::mutableRow : access out of bounds");
+        auto& rowNode = writableLeaf(n)->rows[n & (cowBranching - 1)];
+        if (rowNode->epoch != epoch_) {
+            rowNode = std::make_shared<CowRowNode<Row>>(CowRowNode<Row>{epoch_, rowNode->row});
+        }
+        return rowNode->row;
+    }
+    /** \brief Replaces a row, without cloning it */
+    void assignRow(size_type n, Row row) {
+        if (n >= size_) throw std::runtime_error("CowContainer::assignRow : access out of bounds");
+        writableLeaf(n)->rows[n & (cowBranching - 1)] =
+            std::make_shared<CowRowNode<Row>>(CowRowNode<Row>{epoch_, std::move(row)});
+    }
+    /** \brief Appends a row */
+    void pushBack(Row row) {
+        if (size_ == (size_t{1} << (cowShift * depth_))) {
+            // full trie: the root becomes the first child of a new one
+            auto newRoot = newNode();
+            newRoot->children.push_back(std::move(root_));
+            root_ = std::move(newRoot);
+            ++depth_;
+        }
+        CowNode<Row>* node = writableRoot();
+        for (size_t level = depth_ - 1; level > 0; --level) {
+            const size_t child = (size_ >> (cowShift * level)) & (cowBranching - 1);
+            if (child == node->children.size()) node->children.push_back(newNode());
+            node = writableChild(node, child);
+        }
+        node->rows.push_back(std::make_shared<CowRowNode<Row>>(CowRowNode<Row>{epoch_, std::move(row)}));
+        ++size_;
+    }
+
+    size_type size() const {return size_;}
+    bool empty() const {return (size() == 0);}
+
+    /** \brief Returns the current version of the container, in constant time.
+     * The following modifications do not affect it. */
+    Snapshot snapshot() {
+        ++epoch_;   // freezes the current nodes
+        return Snapshot{root_, depth_, size_};
+    }
+
+private:
+    std::shared_ptr<CowNode<Row>> newNode() const {
+        auto node = std::make_shared<CowNode<Row>>();
+        node->epoch = epoch_;
+        return node;
+    }
+
+    // Returns a node of the current epoch, cloning it if needed
+    CowNode<Row>* writable(std::shared_ptr<CowNode<Row>>& node) const {
+        if (node->epoch != epoch_) {
+            node = std::make_shared<CowNode<Row>>(*node);
+            node->epoch = epoch_;
+        }
+        return node.get();
+    }
+    CowNode<Row>* writableRoot() {return writable(root_);}
+    CowNode<Row>* writableChild(CowNode<Row>* node, size_t child) const {
+        return writable(node->children[child]);
+    }
+    CowNode<Row>* writableLeaf(size_t index) {
+        CowNode<Row>* node = writableRoot();
+        for (size_t level = depth_ - 1; level > 0; --level) {
+            node = writableChild(node, (index >> (cowShift * level)) & (cowBranching - 1));
+        }
+        return node;
+    }
+
+private:
+    mutable uint64_t epoch_;
+        // the nodes of this epoch belong only to this container;
+        // incremented by the copies too, see the copy constructor
+    size_t depth_;
+    size_t size_;
+    std::shared_ptr<CowNode<Row>> root_;
+};
+
+} // namespace multidim - CowContainer
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @ConcurrentJagged
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+// **************************************************************************
+// forward declarations
+template <typename T>
+class ConcurrentJagged;
+
+//***************************************************************************
+// ConcurrentJaggedIterator
+//***************************************************************************
+/** \brief The iterator of a ConcurrentJaggedView: a random access iterator
+ * on its (const) rows
+ * \ingroup concurrent_jagged
+ */
+template <typename T>
+class ConcurrentJaggedIterator {
+public:
+    // [iterator.traits]
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::vector<T>;
+    using difference_type = ptrdiff_t;
+    using pointer = const std::vector<T>*;
+    using reference = const std::vector<T>&;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    ConcurrentJaggedIterator() : container_{nullptr}, index_{0} {}
+    /* \brief Default constructor. */
+
+    ConcurrentJaggedIterator(const ConcurrentJagged<T>* container, size_t index) :
+        container_{container}, index_{index} {}
+
+    ConcurrentJaggedIterator(const ConcurrentJaggedIterator&) = default;
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    // [iterator.iterators]
+    reference operator*() const {return container_->publishedRow(index_);}
+    pointer operator->() const {return &**this;}
+    ConcurrentJaggedIterator& operator++() {++index_; return *this;}
+
+    // [input.iterators] and [output.iterators]
+    bool operator==(const ConcurrentJaggedIterator& other) const {return index_ == other.index_;}
+    bool operator!=(const ConcurrentJaggedIterator& other) const {return !((*this) == other);}
+    ConcurrentJaggedIterator operator++(int) {auto tmp = *this; ++(*this); return tmp;}
+
+    // [bidirectional.iterators]
+    ConcurrentJaggedIterator& operator--() {--index_; return *this;}
+    ConcurrentJaggedIterator operator--(int) {auto other = *this; --(*this); return other;}
+
+    // [random.access.iterators]
+    ConcurrentJaggedIterator& operator+=(difference_type n) {index_ += n; return *this;}
+    ConcurrentJaggedIterator operator+(difference_type n) const {auto result = (*this); result += n; return result;}
+    friend ConcurrentJaggedIterator operator+(difference_type n, const ConcurrentJaggedIterator& other) {return other + n;}
+    ConcurrentJaggedIterator& operator-=(difference_type n) {return (*this += (-n));}
+    ConcurrentJaggedIterator operator-(difference_type n) const {return (*this + (-n));}
+
+    difference_type operator-(const ConcurrentJaggedIterator& other) const {
+        return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+    bool operator<(const ConcurrentJaggedIterator& other) const {return index_ < other.index_;}
+    bool operator>(const ConcurrentJaggedIterator& other) const {return index_ > other.index_;}
+    bool operator>=(const ConcurrentJaggedIterator& other) const {return !((*this) < other);}
+    bool operator<=(const ConcurrentJaggedIterator& other) const {return !((*this) > other);}
+
+    reference operator[](difference_type n) const {return *(*this + n);}
+
+private: // members
+    const ConcurrentJagged<T>* container_;
+    size_t index_;
+};
+
+//***************************************************************************
+// ConcurrentJaggedView
+//***************************************************************************
+/** \brief A View of the rows of a ConcurrentJagged which were published
+ * when it was taken, i.e. a consistent range of const rows, which can be
+ * read (e.g. through a FlatView) while the producers keep appending
+ * \ingroup concurrent_jagged
+ */
+template <typename T>
+class ConcurrentJaggedView {
+public:
+    using iterator = ConcurrentJaggedIterator<T>;
+    using const_iterator = iterator;
+    using value_type = std::vector<T>;
+    using reference = const std::vector<T>&;
+    using const_reference = reference;
+    using difference_type = ptrdiff_t;
+    using size_type = size_t;
+
+    ConcurrentJaggedView() : container_{nullptr}, size_{0} {}
+    ConcurrentJaggedView(const ConcurrentJagged<T>* container, size_t size) :
+        container_{container}, size_{size} {}
+
+    iterator begin() const {return iterator{container_, 0};}
+    const_iterator cbegin() const {return begin();}
+    iterator end() const {return iterator{container_, size_};}
+    const_iterator cend() const {return end();}
+
+    reference operator[](size_type n) const {return container_->publishedRow(n);}
+    size_type size() const {return size_;}
+    bool empty() const {return (size() == 0);}
+
+private:
+    const ConcurrentJagged<T>* container_;
+    size_t size_;
+};
+
+//***************************************************************************
+// ConcurrentJagged
+//***************************************************************************
+/** \brief An append-only jagged container (the concurrent counterpart of a
+ * `std::vector<std::vector<T>>`) which many producers can fill at once
+ * without locks:
+ * - a producer reserves a row with an atomic increment (`reserveRow`),
+ *   fills it privately (`row`), then publishes it (`publish`);
+ *   `pushBack` does the three in one step;
+ * - the rows live in segments of doubling size, which are allocated once
+ *   and never relocated, so the published rows stay in place;
+ * - `view()` returns, without blocking the producers, a View of the
+ *   longest prefix of published rows, e.g. to build a FlatView on it.
+ * A published row must not be modified anymore.
+ * \ingroup concurrent_jagged
+ */
+template <typename T>
+class ConcurrentJagged {
+    struct Slot {
+        std::atomic<bool> published{false};
+        std::vector<T> row;
+    };
+
+    static constexpr size_t firstSegmentSize = 64;
+    static constexpr size_t maxSegments = 48;  // i.e. up to 2^54 rows
+
+public:
+    using View = ConcurrentJaggedView<T>;
+    using size_type = size_t;
+
+    ConcurrentJagged() : reserved_{0}, publishedPrefix_{0} {
+        for (auto& segment : segments_) segment.store(nullptr, std::memory_order_relaxed);
+    }
+    ConcurrentJagged(const ConcurrentJagged&) = delete;
+    ConcurrentJagged& operator=(const ConcurrentJagged&) = delete;
+    ~ConcurrentJagged() {
+        for (auto& segment : segments_) {
+            Slot* slots = segment.load(std::memory_order_relaxed);
+            if (slots != failedSegment()) delete[] slots;
+        }
+    }
+
+    // **************************************************************************
+    // Producers
+    // **************************************************************************
+    /** \brief Reserves a new (empty) row and returns its index.
+     * The row is private to the caller until it is published. */
+    size_type reserveRow() {
+        const size_t index = reserved_.fetch_add(1, std::memory_order_relaxed);
+        slot(index, true);     // allocates the segment if needed
+        return index;
+    }
+    /** \brief A reserved row, to be filled by the producer which reserved it
+     * before publishing it */
+    std::vector<T>& row(size_type index) {return slot(index, false).row;}
+    /** \brief Makes a reserved row visible to the readers */
+    void publish(size_type index) {
+        slot(index, false).published.store(true);
+        advancePublishedPrefix();
+    }
+    /** \brief Appends a row and publishes it, returning its index */
+    size_type pushBack(std::vector<T> newRow) {
+        const size_t index = reserveRow();
+        row(index) = std::move(newRow);
+        publish(index);
+        return index;
+    }
+
+    // **************************************************************************
+    // Readers
+    // **************************************************************************
+    /** \brief A View of the longest prefix of published rows */
+    View view() const {
+        return View{this, publishedPrefix_.load(std::memory_order_acquire)};
+    }
+    /** \brief The number of reserved rows (published or not) */
+    size_type reservedSize() const {return reserved_.load(std::memory_order_relaxed);}
+    /** \brief The number of rows in the published prefix */
+    size_type publishedSize() const {return publishedPrefix_.load(std::memory_order_acquire);}
+
+    /** \brief A row of the published prefix */
+    const std::vector<T>& publishedRow(size_type index) const {
+        const size_t segment = segmentOf(index);
+        return segments_[segment].load(std::memory_order_acquire)[index - segmentFirst(segment)].row;
+    }
+
+private:
+    // Segment k holds firstSegmentSize * 2^k rows
+    static size_t segmentOf(size_t index) {return floorLog2(index / firstSegmentSize + 1);}
+    static size_t segmentFirst(size_t segment) {return firstSegmentSize * ((size_t{1} << segment) - 1);}
+
+    Slot& slot(size_t index, bool allocate) {
+        const size_t segment = segmentOf(index);
+        if (segment >= maxSegments) throw std::runtime_error("ConcurrentJagged : too many rows");
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        if (slots == nullptr && allocate) {
+            slots = installSegment(segment, index == segmentFirst(segment));
+        }
+        if (slots == failedSegment()) {
+            throw std::runtime_error("ConcurrentJagged : a segment could not be allocated");
+        }
+        return slots[index - segmentFirst(segment)];
+    }
+
+    // Only the producer which reserved the first row of a new segment
+    // allocates it; the others wait until it is installed, so a segment
+    // is never allocated twice
+    Slot* installSegment(size_t segment, bool allocate) {
+        if (allocate) {
+            Slot* slots = nullptr;
+            try {
+                slots = new Slot[firstSegmentSize << segment];
+            } catch (...) {
+                // do not leave the waiting producers spinning
+                segments_[segment].store(failedSegment(), std::memory_order_release);
+                throw;
+            }
+            segments_[segment].store(slots, std::memory_order_release);
+            return slots;
+        }
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        while (slots == nullptr) {
+            std::this_thread::yield();
+            slots = segments_[segment].load(std::memory_order_acquire);
+        }
+        return slots;
+    }
+
+    // Installed in place of a segment whose allocation threw
+    static Slot* failedSegment() {
+        static Slot failed;
+        return &failed;
+    }
+
+    // Any producer can push the prefix over the rows published by the others.
+    // The publication flags and the prefix use sequentially consistent
+    // operations, so that of two producers publishing concurrently,
+    // at least one sees the row of the other
+    void advancePublishedPrefix() {
+        size_t prefix = publishedPrefix_.load();
+        while (prefix < reserved_.load()) {
+            // the segment of a reserved row may not be allocated yet
+            const size_t segment = segmentOf(prefix);
+            if (segment >= maxSegments) break;
+            const Slot* slots = segments_[segment].load(std::memory_order_acquire);
+            if (slots == nullptr || slots == failedSegment()) break;
+            if (!slots[prefix - segmentFirst(segment)].published.load()) break;
+            if (publishedPrefix_.compare_exchange_weak(prefix, prefix + 1)) ++prefix;
+        }
+    }
+
+private:
+    std::atomic<size_t> reserved_;
+    std::atomic<size_t> publishedPrefix_;
+    std::array<std::atomic<Slot*>, maxSegments> segments_;
+};
+
+template <typename T>
+constexpr size_t ConcurrentJagged<T>::firstSegmentSize;
+
+} // namespace multidim - ConcurrentJagged
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @SmallVector
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// SmallVector
+//***************************************************************************
+/** \brief A vector which stores up to `inlineCapacity` elements inline,
+ * i.e. in the object itself, and only longer sequences on the heap.
+ * Used as the row type of a jagged container (see SmallJagged),
+ * it saves a heap block per short row, and a FlatView reaches
+ * the elements of the inline rows without a pointer chase, since
+ * they lie next to the row in the memory of the outer container.
+ * Its iterators are plain pointers, so each row is a contiguous segment
+ * for the FlatView machinery, and it works unchanged with `bounds`,
+ * `scalarSize`, the Views etc.
+ * \param T the type of the elements
+ * \param inlineCapacity the number of elements stored inline
+ * \ingroup small_vector
+ */
+template <typename T, size_t inlineCapacity = 4>
+class SmallVector {
+    static_assert(inlineCapacity > 0, "SmallVector : the inline capacity must be > 0");
+
+public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using difference_type = ptrdiff_t;
+    using size_type = size_t;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    SmallVector() : data_{inlineData()}, size_{0}, capacity_{inlineCapacity} {}
+    explicit SmallVector(size_type count) : SmallVector{} {resize(count);}
+    SmallVector(size_type count, const T& value) : SmallVector{} {assign(count, value);}
+    template <
+        typename InputIterator,
+        typename = typename std::iterator_traits<InputIterator>::iterator_category
+    >
+    SmallVector(InputIterator first, InputIterator last) : SmallVector{} {assign(first, last);}
+    SmallVector(std::initializer_list<T> values) : SmallVector{} {assign(values.begin(), values.end());}
+    SmallVector(const SmallVector& other) : SmallVector{} {assign(other.begin(), other.end());}
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) :
+        SmallVector{} {moveFrom(other);}
+        /**< \note Being noexcept, it lets `std::vector` move the rows
+         * instead of copying them when it grows */
+    ~SmallVector() {
+        clear();
+        releaseHeap();
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        if (this != &other) {
+            clear();
+            releaseHeap();
+            moveFrom(other);
+        }
+        return *this;
+    }
+    SmallVector& operator=(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+        return *this;
+    }
+
+    void assign(size_type count, const T& value) {
+        const T copy(value);    // the value may be an element
+        clear();
+        reserve(count);
+        for (; size_ < count; ++size_) new (data_ + size_) T(copy);
+    }
+    template <
+        typename InputIterator,
+        typename = typename std::iterator_traits<InputIterator>::iterator_category
+    >
+    void assign(InputIterator first, InputIterator last) {
+        clear();
+        reserveForRange(first, last, typename std::iterator_traits<InputIterator>::iterator_category{});
+        for (; first != last; ++first) push_back(*first);
+    }
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    bool operator==(const SmallVector& other) const {
+        return size() == other.size() && std::equal(begin(), end(), other.begin());
+    }
+    bool operator!=(const SmallVector& other) const {return !(*this == other);}
+    bool operator <(const SmallVector& other) const {
+        return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
+    }
+    bool operator >(const SmallVector& other) const {return other < *this;}
+    bool operator<=(const SmallVector& other) const {return !(other < *this);}
+    bool operator>=(const SmallVector& other) const {return !(*this < other);}
+
+    iterator begin() {return data_;}
+    const_iterator begin() const {return data_;}
+    const_iterator cbegin() const {return data_;}
+    iterator end() {return data_ + size_;}
+    const_iterator end() const {return data_ + size_;}
+    const_iterator cend() const {return data_ + size_;}
+    reverse_iterator rbegin() {return reverse_iterator{end()};}
+    const_reverse_iterator rbegin() const {return const_reverse_iterator{end()};}
+    const_reverse_iterator crbegin() const {return rbegin();}
+    reverse_iterator rend() {return reverse_iterator{begin()};}
+    const_reverse_iterator rend() const {return const_reverse_iterator{begin()};}
+    const_reverse_iterator crend() const {return rend();}
+
+    reference operator[](size_type n) {return data_[n];}
+    const_reference operator[](size_type n) const {return data_[n];}
+    reference at(size_type n) {checkIndex(n); return data_[n];}
+    const_reference at(size_type n) const {checkIndex(n); return data_[n];}
+    reference front() {return data_[0];}
+    const_reference front() const {return data_[0];}
+    reference back() {return data_[size_ - 1];}
+    const_reference back() const {return data_[size_ - 1];}
+    T* data() {return data_;}
+    const T* data() const {return data_;}
+
+    size_type size() const {return size_;}
+    size_type max_size() const {return std::numeric_limits<size_type>::max() / sizeof(T);}
+    bool empty() const {return (size() == 0);}
+    size_type capacity() const {return capacity_;}
+    /** \brief Whether the elements are stored inline */
+    bool isInline() const {return data_ == inlineData();}
+
+    void reserve(size_type newCapacity) {
+        if (newCapacity > capacity_) reallocate(newCapacity);
+    }
+    /** \brief Moves the elements back inline if they fit, otherwise
+     * shrinks the heap block to their number */
+    void shrink_to_fit() {
+        if (!isInline() && size_ < capacity_) reallocate(size_);
+    }
+
+    void push_back(const T& value) {emplace_back(value);}
+    void push_back(T&& value) {emplace_back(std::move(value));}
+    template <typename... Arguments>
+    reference emplace_back(Arguments&&... arguments) {
+        if (size_ == capacity_) {
+            // the argument may be an element: build it before reallocating
+            T value(std::forward<Arguments>(arguments)...);
+            reallocate(2 * capacity_);
+            new (data_ + size_) T(std::move(value));
+        } else {
+            new (data_ + size_) T(std::forward<Arguments>(arguments)...);
+        }
+        return data_[size_++];
+    }
+    void pop_back() {data_[--size_].~T();}
+
+    void resize(size_type count) {
+        if (count < size_) {
+            while (size_ > count) pop_back();
+        } else {
+            reserve(count);
+            for (; size_ < count; ++size_) new (data_ + size_) T();
+        }
+    }
+    void resize(size_type count, const T& value) {
+        if (count < size_) {
+            while (size_ > count) pop_back();
+        } else if (count > capacity_) {
+            // the value may be an element: copy it before reallocating
+            const T copy(value);
+            reserve(count);
+            for (; size_ < count; ++size_) new (data_ + size_) T(copy);
+        } else {
+            for (; size_ < count; ++size_) new (data_ + size_) T(value);
+        }
+    }
+    void clear() {
+        while (size_ > 0) pop_back();
+    }
+
+    void swap(SmallVector& other) {
+        SmallVector tmp{std::move(other)};
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+private:
+    T* inlineData() {return reinterpret_cast<T*>(&inline_);}
+    const T* inlineData() const {return reinterpret_cast<const T*>(&inline_);}
+
+    void checkIndex(size_type n) const {
+        if (n >= size_) throw std::runtime_error("SmallVector::at : access out of bounds");
+    }
+
+    template <typename Iterator>
+    void reserveForRange(Iterator first, Iterator last, std::forward_iterator_tag) {
+        reserve(static_cast<size_type>(std::distance(first, last)));
+    }
+    template <typename Iterator>
+    void reserveForRange(Iterator, Iterator, std::input_iterator_tag) {}
+
+    // Moves the elements to a buffer of `newCapacity` (inline if it fits)
+    void reallocate(size_type newCapacity) {
+        T* newData = (newCapacity <= inlineCapacity) ?
+            inlineData() : static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+        if (newData == data_) return;
+        for (size_type i = 0; i < size_; ++i) {
+            new (newData + i) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+        releaseHeap();
+        data_ = newData;
+        capacity_ = std::max(newCapacity, inlineCapacity);
+    }
+
+    void releaseHeap() {
+        if (!isInline()) ::operator delete(data_);
+        data_ = inlineData();
+        capacity_ = inlineCapacity;
+    }
+
+    // Requires an empty inline *this: steals the heap block of `other`,
+    // or moves its inline elements one by one
+    void moveFrom(SmallVector& other) {
+        if (other.isInline()) {
+            for (size_type i = 0; i < other.size_; ++i) new (data_ + i) T(std::move(other.data_[i]));
+            size_ = other.size_;
+            other.clear();
+        } else {
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inlineData();
+            other.size_ = 0;
+            other.capacity_ = inlineCapacity;
+        }
+    }
+
+private:
+    T* data_;
+    size_type size_;
+    size_type capacity_;
+    typename std::aligned_storage<sizeof(T) * inlineCapacity, alignof(T)>::type inline_;
+};
+
+template <typename T, size_t inlineCapacity>
+void swap(SmallVector<T, inlineCapacity>& a, SmallVector<T, inlineCapacity>& b) {a.swap(b);}
+
+/** \brief A jagged container whose rows store up to `inlineCapacity`
+ * elements inline, see SmallVector
+ * \ingroup small_vector
+ */
+template <typename T, size_t inlineCapacity = 4>
+using SmallJagged = std::vector<SmallVector<T, inlineCapacity>>;
+
+} // namespace multidim - SmallVector
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @SegmentedVector
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// SegmentedIterator
+//***************************************************************************
+/** \brief The iterators of a SegmentedVector: if `isChunkIterator`,
+ * a random access iterator on its chunks, seen as contiguous spans
+ * (`ReshapedRange<T, 1>`); otherwise, on its elements.
+ * They address the chunks through the SegmentedVector, so they survive
+ * the appends, and the range they delimit does not change.
+ * \param Vector the SegmentedVector, const-qualified for const iterators
+ * \ingroup segmented_vector
+ */
+template <typename Vector, bool isChunkIterator>
+class SegmentedIterator {
+    using Element = typename std::conditional<
+        std::is_const<Vector>::value,
+        const typename Vector::value_type,
+        typename Vector::value_type
+    >::type;
+
+public:
+    // [iterator.traits]
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename std::conditional<
+        isChunkIterator, ReshapedRange<Element, 1>, typename Vector::value_type
+    >::type;
+    using difference_type = ptrdiff_t;
+    using pointer = typename std::conditional<isChunkIterator, value_type*, Element*>::type;
+    using reference = typename std::conditional<isChunkIterator, value_type, Element&>::type;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    SegmentedIterator() : vector_{nullptr}, index_{0}, size_{0} {}
+    /* \brief Default constructor. */
+
+    /** \param vector the SegmentedVector
+     * \param index the index of the pointed chunk or element
+     * \param size the number of elements of the vector seen by the iterator
+     */
+    SegmentedIterator(Vector* vector, size_t index, size_t size) :
+        vector_{vector}, index_{index}, size_{size} {}
+
+    SegmentedIterator(const SegmentedIterator&) = default;
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    // [iterator.iterators]
+    reference operator*() const {return dereference(std::integral_constant<bool, isChunkIterator>{});}
+    SegmentedIterator& operator++() {++index_; return *this;}
+
+    // [input.iterators] and [output.iterators]
+    bool operator==(const SegmentedIterator& other) const {return index_ == other.index_;}
+    bool operator!=(const SegmentedIterator& other) const {return !((*this) == other);}
+    SegmentedIterator operator++(int) {auto tmp = *this; ++(*this); return tmp;}
+
+    // [bidirectional.iterators]
+    SegmentedIterator& operator--() {--index_; return *this;}
+    SegmentedIterator operator--(int) {auto other = *this; --(*this); return other;}
+
+    // [random.access.iterators]
+    SegmentedIterator& operator+=(difference_type n) {index_ += n; return *this;}
+    SegmentedIterator operator+(difference_type n) const {auto result = (*this); result += n; return result;}
+    friend SegmentedIterator operator+(difference_type n, const SegmentedIterator& other) {return other + n;}
+    SegmentedIterator& operator-=(difference_type n) {return (*this += (-n));}
+    SegmentedIterator operator-(difference_type n) const {return (*this + (-n));}
+
+    difference_type operator-(const SegmentedIterator& other) const {
+        return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+    bool operator<(const SegmentedIterator& other) const {return index_ < other.index_;}
+    bool operator>(const SegmentedIterator& other) const {return index_ > other.index_;}
+    bool operator>=(const SegmentedIterator& other) const {return !((*this) < other);}
+    bool operator<=(const SegmentedIterator& other) const {return !((*this) > other);}
+
+    reference operator[](difference_type n) const {return *(*this + n);}
+
+private:
+    reference dereference(std::true_type) const {
+        const size_t first = index_ * Vector::chunkSize;
+        return value_type{
+            vector_->chunkData(index_), nullptr, 0,
+            std::min<size_t>(Vector::chunkSize, size_ - first)
+        };
+    }
+    reference dereference(std::false_type) const {
+        return vector_->chunkData(index_ / Vector::chunkSize)[index_ % Vector::chunkSize];
+    }
+
+private: // members
+    Vector* vector_;
+    size_t index_;
+    size_t size_;
+};
+
+//***************************************************************************
+// SegmentedChunks
+//***************************************************************************
+/** \brief The range of the chunks of a SegmentedVector, see
+ * `SegmentedVector::chunks`
+ * \ingroup segmented_vector
+ */
+template <typename Vector>
+class SegmentedChunks {
+public:
+    using iterator = SegmentedIterator<Vector, true>;
+    using const_iterator = iterator;
+    using value_type = typename iterator::value_type;
+    using reference = typename iterator::reference;
+    using const_reference = reference;
+    using difference_type = ptrdiff_t;
+    using size_type = size_t;
+
+    SegmentedChunks(Vector* vector, size_t size) : vector_{vector}, size_{size} {}
+
+    iterator begin() const {return iterator{vector_, 0, size_};}
+    const_iterator cbegin() const {return begin();}
+    iterator end() const {return iterator{vector_, this->size(), size_};}
+    const_iterator cend() const {return end();}
+
+    reference operator[](size_type n) const {return begin()[static_cast<difference_type>(n)];}
+    /** \brief The number of chunks */
+    size_type size() const {return (size_ + Vector::chunkSize - 1) / Vector::chunkSize;}
+    bool empty() const {return (size() == 0);}
+
+private:
+    Vector* vector_;
+    size_t size_;
+};
+
+//***************************************************************************
+// SegmentedVector
+//***************************************************************************
+/** \brief A vector made of fixed-size chunks: appending never moves
+ * the existing elements (their addresses are stable), and costs O(1)
+ * without the reallocation spikes of a `std::vector`.
+ * The iterators and Views taken on it stay valid under appends,
+ * showing the elements present when they were taken.
+ * `makeFlatView` sees its chunks as contiguous segments (see `chunks`),
+ * so flat iteration, filtering etc. run one chunk at a time.
+ * \param T the type of the elements
+ * \param chunkSize_ the number of elements of a chunk (a power of 2)
+ * \ingroup segmented_vector
+ */
+template <typename T, size_t chunkSize_ = 1024>
+class SegmentedVector {
+    static_assert(
+        chunkSize_ > 0 && (chunkSize_ & (chunkSize_ - 1)) == 0,
+        "SegmentedVector : the chunk size must be a power of 2"
+    );
+
+public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = SegmentedIterator<SegmentedVector, false>;
+    using const_iterator = SegmentedIterator<const SegmentedVector, false>;
+    using difference_type = ptrdiff_t;
+    using size_type = size_t;
+
+    static constexpr size_t chunkSize = chunkSize_;
+
+    // **************************************************************************
+    // ctors
+    // **************************************************************************
+    SegmentedVector() : size_{0} {}
+    // The constructors filling the vector delegate to the default one,
+    // so that the destructor releases the elements if a copy throws
+    SegmentedVector(std::initializer_list<T> values) : SegmentedVector{} {
+        for (const auto& value : values) push_back(value);
+    }
+    SegmentedVector(const SegmentedVector& other) : SegmentedVector{} {
+        for (const auto& value : other) push_back(value);
+    }
+    SegmentedVector(SegmentedVector&& other) noexcept :
+        chunks_{std::move(other.chunks_)}, size_{other.size_}
+    {
+        other.chunks_.clear();
+        other.size_ = 0;
+    }
+    /**< \note It invalidates the iterators and Views of `other` */
+    ~SegmentedVector() {
+        clear();
+        for (T* chunk : chunks_) ::operator delete(chunk);
+    }
+    SegmentedVector& operator=(SegmentedVector other) {
+        swap(other);
+        return *this;
+    }
+
+    // **************************************************************************
+    // Standard members
+    // **************************************************************************
+    bool operator==(const SegmentedVector& other) const {
+        return size() == other.size() && std::equal(begin(), end(), other.begin());
+    }
+    bool operator!=(const SegmentedVector& other) const {return !(*this == other);}
+
+    iterator begin() {return iterator{this, 0, size_};}
+    const_iterator begin() const {return const_iterator{this, 0, size_};}
+    const_iterator cbegin() const {return begin();}
+    iterator end() {return iterator{this, size_, size_};}
+    const_iterator end() const {return const_iterator{this, size_, size_};}
+    const_iterator cend() const {return end();}
+
+    reference operator[](size_type n) {return chunks_[n / chunkSize][n % chunkSize];}
+    const_reference operator[](size_type n) const {return chunks_[n / chunkSize][n % chunkSize];}
+    reference at(size_type n) {checkIndex(n); return (*this)[n];}
+    const_reference at(size_type n) const {checkIndex(n); return (*this)[n];}
+    reference front() {return (*this)[0];}
+    const_reference front() const {return (*this)[0];}
+    reference back() {return (*this)[size_ - 1];}
+    const_reference back() const {return (*this)[size_ - 1];}
+
+    size_type size() const {return size_;}
+    bool empty() const {return (size() == 0);}
+    size_type capacity() const {return chunks_.size() * chunkSize;}
+
+    /** \brief Allocates the chunks for `count` elements */
+    void reserve(size_type count) {
+        while (capacity() < count) addChunk();
+    }
+
+    void push_back(const T& value) {emplace_back(value);}
+    void push_back(T&& value) {emplace_back(std::move(value));}
+    template <typename... Arguments>
+    reference emplace_back(Arguments&&... arguments) {
+        if (size_ == capacity()) addChunk();
+        T* slot = chunks_[size_ / chunkSize] + size_ % chunkSize;
+        new (slot) T(std::forward<Arguments>(arguments)...);
+        ++size_;
+        return *slot;
+    }
+    /** \note The iterators and Views including the last element
+     *  are invalidated */
+    void pop_back() {
+        --size_;
+        (*this)[size_].~T();
+    }
+    /** \brief Destroys the elements, keeping the chunks */
+    void clear() {
+        while (size_ > 0) pop_back();
+    }
+    void swap(SegmentedVector& other) {
+        chunks_.swap(other.chunks_);
+        std::swap(size_, other.size_);
+    }
+
+    // **************************************************************************
+    // Chunks
+    // **************************************************************************
+    /** \brief The range of the chunks holding the elements, each one seen
+     * as a contiguous span (the last one possibly partial).
+     * Building a FlatView on it gives the same elements as the vector,
+     * but the segments of the FlatView are whole chunks. */
+    SegmentedChunks<SegmentedVector> chunks() {return {this, size_};}
+    SegmentedChunks<const SegmentedVector> chunks() const {return {this, size_};}
+
+    T* chunkData(size_type chunk) {return chunks_[chunk];}
+    const T* chunkData(size_type chunk) const {return chunks_[chunk];}
+
+private:
+    void addChunk() {
+        chunks_.reserve(chunks_.size() + 1);    // so that push_back cannot throw
+        chunks_.push_back(static_cast<T*>(::operator new(chunkSize * sizeof(T))));
+    }
+    void checkIndex(size_type n) const {
+        if (n >= size_) throw std::runtime_error("SegmentedVector::at : access out of bounds");
+    }
+
+private:
+    std::vector<T*> chunks_;
+    size_t size_;
+};
+
+template <typename T, size_t chunkSize_>
+constexpr size_t SegmentedVector<T, chunkSize_>::chunkSize;
+
+template <typename T, size_t chunkSize>
+void swap(SegmentedVector<T, chunkSize>& a, SegmentedVector<T, chunkSize>& b) {a.swap(b);}
+
+/** \brief Factory method to build a FlatView of a SegmentedVector, whose
+ * segments are its chunks (see `SegmentedVector::chunks`): the same
+ * elements as the vector, iterated one contiguous chunk at a time
+ * \ingroup user_functions
+ */
+template <template<typename> class ScalarPolicy = NoCustomScalars, typename T = void, size_t chunkSize = 0>
+auto makeFlatView(SegmentedVector<T, chunkSize>& vector)
+    -> FlatView<ScalarPolicy, typename SegmentedChunks<SegmentedVector<T, chunkSize>>::iterator>
+{
+    const auto chunks = vector.chunks();
+    return makeFlatView<ScalarPolicy>(chunks.begin(), chunks.end());
+}
+
+template <template<typename> class ScalarPolicy = NoCustomScalars, typename T = void, size_t chunkSize = 0>
+auto makeFlatView(const SegmentedVector<T, chunkSize>& vector)
+    -> FlatView<ScalarPolicy, typename SegmentedChunks<const SegmentedVector<T, chunkSize>>::iterator>
+{
+    const auto chunks = vector.chunks();
+    return makeFlatView<ScalarPolicy>(chunks.begin(), chunks.end());
+}
+
+} // namespace multidim - SegmentedVector
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @Soa
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// SoaColumns
+//***************************************************************************
+/** \brief Some fields of the leaf structs of a nested container,
+ * each one materialized as a dense column (structure of arrays),
+ * see `toSoa`.
+ * \ingroup user_functions
+ */
+template <typename... Fields>
+struct SoaColumns {
+    static_assert(sizeof...(Fields) > 0, "SoaColumns : at least one field is needed");
+
+    std::tuple<std::vector<Fields>...> columns;
+        /**< the columns, in the order of the fields */
+    std::vector<std::vector<size_t>> lengths;
+        /**< the shape shared by the columns: for each level but the last one,
+         * the lengths of its subranges, as expected by `makeReshapedView`
+         * and `buildNested` (empty for monolevel containers) */
+
+    /** \brief The column of the `index`-th field */
+    template <size_t index>
+    typename std::tuple_element<index, std::tuple<std::vector<Fields>...>>::type& column() {
+        return std::get<index>(columns);
+    }
+    template <size_t index>
+    const typename std::tuple_element<index, std::tuple<std::vector<Fields>...>>::type& column() const {
+        return std::get<index>(columns);
+    }
+    /** \brief The number of leaf elements, i.e. the length of the columns */
+    size_t size() const {return std::get<0>(columns).size();}
+};
+
+//***************************************************************************
+// collectLengths
+//***************************************************************************
+// Appends the lengths of the subranges of [first, last) to the lengths
+// of their level, and so on recursively
+
+// Version for monolevel ranges: no subranges
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    typename std::enable_if<
+        IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value,
+        long
+    >::type = 0xBEEF
+>
+void collectLengths(Iterator, Iterator, size_t, std::vector<std::vector<size_t>>&) {}
+
+// Version for multilevel ranges
+template <
+    template<typename> class ScalarPolicy,
+    typename Iterator,
+    typename std::enable_if<
+        (false == IsScalar<ScalarPolicy, typename std::iterator_traits<Iterator>::value_type>::value),
+        int
+    >::type = 0xBEEF
+>
+void collectLengths(Iterator first, Iterator last, size_t level, std::vector<std::vector<size_t>>& lengths) {
+    for (auto it = first; it != last; ++it) {
+        lengths[level].push_back(static_cast<size_t>(std::distance(begin(*it), end(*it))));
+        collectLengths<ScalarPolicy>(begin(*it), end(*it), level + 1, lengths);
+    }
+}
+
+template <template<typename> class ScalarPolicy, typename Container>
+std::vector<std::vector<size_t>> containerLengths(Container& container) {
+    std::vector<std::vector<size_t>> lengths(Dimensionality<ScalarPolicy, Container>::value - 1);
+    collectLengths<ScalarPolicy>(begin(container), end(container), 0, lengths);
+    return lengths;
+}
+
+//***************************************************************************
+// forEachSoaSegment
+//***************************************************************************
+// Calls function(first, count, position) for each segment of the leaf
+// elements of `container`, `position` being the index of its first element
+// in the flattened container. The outermost dimension is split among the
+// threads of `executor`.
+template <template<typename> class ScalarPolicy, typename Container, typename Function>
+void forEachSoaSegment(
+    Container& container, const std::vector<std::vector<size_t>>& lengths,
+    Executor& executor, const Function& function
+) {
+    using RawIterator = decltype(begin(container));
+    using SegmentIterator = typename FlatView<ScalarPolicy, RawIterator>::iterator::SegmentIterator;
+
+    // the position of the first leaf element of each outer row
+    const size_t rowCount = static_cast<size_t>(std::distance(begin(container), end(container)));
+    std::unique_ptr<ReshapeOffsets> offsets;
+    if (!lengths.empty()) offsets.reset(new ReshapeOffsets{lengths, "toSoa"});
+    const auto rowPosition = [&](size_t row) {
+        size_t position = row;
+        if (offsets) {
+            for (const ReshapeLevel& level : offsets->levels) position = level[position];
+        }
+        return position;
+    };
+
+    parallelChunks(executor, rowCount, parallelChunkCount(executor, rowCount, 16),
+        [&](size_t, size_t chunkBegin, size_t chunkEnd) {
+            const auto first = std::next(begin(container), static_cast<ptrdiff_t>(chunkBegin));
+            const auto last = std::next(first, static_cast<ptrdiff_t>(chunkEnd - chunkBegin));
+            size_t position = rowPosition(chunkBegin);
+            forEachSegment(makeFlatView<ScalarPolicy>(first, last), [&](SegmentIterator segmentFirst, size_t count) {
+                function(segmentFirst, count, position);
+                position += count;
+            });
+        }
+    );
+}
+
+//***************************************************************************
+// copyField, scatterFields, gatherFields
+//***************************************************************************
+// Copies a field of `count` structs to a column (and back)
+template <typename SegmentIterator, typename Struct, typename Field>
+void copyField(SegmentIterator first, size_t count, Field* column, Field Struct::* member) {
+    for (size_t i = 0; i < count; ++i, ++first) column[i] = (*first).*member;
+}
+template <typename SegmentIterator, typename Struct, typename Field>
+void copyField(const Field* column, size_t count, SegmentIterator first, Field Struct::* member) {
+    for (size_t i = 0; i < count; ++i, ++first) (*first).*member = column[i];
+}
+
+// One pass per field, so that each column is written with unit stride
+template <typename SegmentIterator, typename Struct, typename... Fields, size_t... indices>
+void scatterFields(
+    SegmentIterator first, size_t count, size_t position,
+    std::tuple<std::vector<Fields>...>& columns,
+    const std::tuple<Fields Struct::*...>& members, IndexSequence<indices...>
+) {
+    const int expand[] = {0, (
+        copyField(first, count, std::get<indices>(columns).data() + position, std::get<indices>(members)), 0
+    )...};
+    (void)expand;
+}
+
+template <typename SegmentIterator, typename Struct, typename... Fields, size_t... indices>
+void gatherFields(
+    SegmentIterator first, size_t count, size_t position,
+    const std::tuple<std::vector<Fields>...>& columns,
+    const std::tuple<Fields Struct::*...>& members, IndexSequence<indices...>
+) {
+    const int expand[] = {0, (
+        copyField(std::get<indices>(columns).data() + position, count, first, std::get<indices>(members)), 0
+    )...};
+    (void)expand;
+}
+
+template <typename... Fields, size_t... indices>
+void resizeColumns(std::tuple<std::vector<Fields>...>& columns, size_t size, IndexSequence<indices...>) {
+    const int expand[] = {0, (std::get<indices>(columns).resize(size), 0)...};
+    (void)expand;
+}
+
+template <typename... Fields>
+struct NoBoolFields;
+
+template <>
+struct NoBoolFields<> : std::true_type {};
+
+template <typename Field, typename... Fields>
+struct NoBoolFields<Field, Fields...> : std::integral_constant<
+    bool, !std::is_same<Field, bool>::value && NoBoolFields<Fields...>::value
+> {};
+
+//***************************************************************************
+// toSoa
+//***************************************************************************
+/** \brief Materializes some fields of the leaf structs of a nested
+ * container as dense columns (structure of arrays), e.g.
+ * `toSoa(points, &Point::x, &Point::y)` for a `vector<vector<Point>>`,
+ * so that column-wise kernels read unit-stride data.
+ * The columns share the shape of the container (`SoaColumns::lengths`),
+ * so e.g. `makeReshapedView<2>(soa.column<0>().data(), soa.lengths)`
+ * shows a column with the nesting of the container.
+ * The copy runs one segment at a time, one field after the other,
+ * with the outermost dimension split among the threads of `executor`.
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ * \param executor (optional) the executor running the copy
+ * \param container the container of structs
+ * \param members pointers to the data members to be materialized
+ *  (`bool` ones are not supported, since `std::vector<bool>` is not dense)
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename Struct = void,
+    typename... Fields
+>
+SoaColumns<Fields...> toSoa(Executor& executor, Container& container, Fields Struct::*... members) {
+    static_assert(NoBoolFields<Fields...>::value, "toSoa : bool fields are not supported");
+
+    SoaColumns<Fields...> result;
+    result.lengths = containerLengths<ScalarPolicy>(container);
+    resizeColumns(
+        result.columns, scalarSize<ScalarPolicy>(container),
+        typename MakeIndexSequence<sizeof...(Fields)>::type{}
+    );
+
+    const std::tuple<Fields Struct::*...> memberTuple{members...};
+    using RawIterator = decltype(begin(container));
+    using SegmentIterator = typename FlatView<ScalarPolicy, RawIterator>::iterator::SegmentIterator;
+    forEachSoaSegment<ScalarPolicy>(container, result.lengths, executor,
+        [&](SegmentIterator first, size_t count, size_t position) {
+            scatterFields(
+                first, count, position, result.columns, memberTuple,
+                typename MakeIndexSequence<sizeof...(Fields)>::type{}
+            );
+        }
+    );
+    return result;
+}
+
+/** \brief The same, on the default executor */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename Struct = void,
+    typename... Fields
+>
+SoaColumns<Fields...> toSoa(Container& container, Fields Struct::*... members) {
+    return toSoa<ScalarPolicy>(defaultExecutor(), container, members...);
+}
+
+//***************************************************************************
+// fromSoa
+//***************************************************************************
+/** \brief The reverse of `toSoa`: writes the columns back to the fields
+ * of the leaf structs of a container, which must have their shape
+ * (e.g. the original container, or one built by `buildNested`).
+ * \ingroup user_functions
+ * \param ScalarPolicy (trait template)
+ * \param executor (optional) the executor running the copy
+ * \param soa the columns, e.g. returned by `toSoa`
+ * \param container the container of structs to be written
+ * \param members pointers to the data members, in the order of the columns
+ */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename Struct = void,
+    typename... Fields
+>
+void fromSoa(
+    Executor& executor, const SoaColumns<Fields...>& soa, Container& container,
+    Fields Struct::*... members
+) {
+    if (
+        containerLengths<ScalarPolicy>(container) != soa.lengths
+        || scalarSize<ScalarPolicy>(container) != soa.size()
+    ) {
+        throw std::runtime_error("fromSoa : the container and the columns have different shapes");
+    }
+
+    const std::tuple<Fields Struct::*...> memberTuple{members...};
+    using RawIterator = decltype(begin(container));
+    using SegmentIterator = typename FlatView<ScalarPolicy, RawIterator>::iterator::SegmentIterator;
+    forEachSoaSegment<ScalarPolicy>(container, soa.lengths, executor,
+        [&](SegmentIterator first, size_t count, size_t position) {
+            gatherFields(
+                first, count, position, soa.columns, memberTuple,
+                typename MakeIndexSequence<sizeof...(Fields)>::type{}
+            );
+        }
+    );
+}
+
+/** \brief The same, on the default executor */
+template <
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename Container = void,
+    typename Struct = void,
+    typename... Fields
+>
+void fromSoa(const SoaColumns<Fields...>& soa, Container& container, Fields Struct::*... members) {
+    fromSoa<ScalarPolicy>(defaultExecutor(), soa, container, members...);
+}
+
+} // namespace multidim - Soa
+
+
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+// @Convert
+// **************************************************************************
+// **************************************************************************
+// **************************************************************************
+
+namespace multidim {
+
+//***************************************************************************
+// ConvertScalar
+//***************************************************************************
+/** \brief A function object converting its argument to `To`
+ * with a `static_cast`, see `makeConvertedView` and `convert`.
+ * \ingroup flat_view_adaptors
+ */
+template <typename To>
+struct ConvertScalar {
+    template <typename From>
+    To operator()(const From& value) const {return static_cast<To>(value);}
+};
+
+//***************************************************************************
+// Quantization
+//***************************************************************************
+/** \brief The parameters of an affine quantization:
+ * the real value `x` is represented by the integer
+ * `q = round(x / scale + zeroPoint)`, clamped to the range of its type,
+ * so that `x ~ scale * (q - zeroPoint)`.
+ * \ingroup user_functions
+ */
+struct Quantization {
+    double scale = 1; /**< the real step between consecutive integers, > 0 */
+    double zeroPoint = 0; /**< the integer representing the real 0 */
+
+    Quantization() = default;
+    explicit Quantization(double scale_, double zeroPoint_ = 0) : scale{scale_}, zeroPoint{zeroPoint_} {}
+};
+
+//***************************************************************************
+// QuantizeScalar
+//***************************************************************************
+/** \brief A function object quantizing its argument to the integer type
+ * `To`, see `Quantization`. The computation is done in `float` (or in
+ * `double` for `double` arguments); the values are rounded to the nearest
+ * integer, halfway cases to even, and NaNs give the lowest integer.
+ * \ingroup flat_view_adaptors
+ */
+template <typename To>
+struct QuantizeScalar {
+    static_assert(
+        std::is_integral<To>::value && sizeof(To) <= 2,
+        "QuantizeScalar : the target must be an integer type of at most 16 bits"
+    );
+
+    explicit QuantizeScalar(Quantization quantization) :
+        inverseScale{1 / quantization.scale}, zeroPoint{quantization.zeroPoint}
+    {
+        if (!(quantization.scale > 0)) {
+            throw std::runtime_error("QuantizeScalar : the scale must be positive");
+        }
+    }
+
+    template <typename From>
+    To operator()(const From& value) const {
+        using Compute = typename std::common_type<From, float>::type;
+        const Compute low = static_cast<Compute>(std::numeric_limits<To>::lowest());
+        const Compute high = static_cast<Compute>(std::numeric_limits<To>::max());
+        Compute result =
+            static_cast<Compute>(value) * static_cast<Compute>(inverseScale)
+            + static_cast<Compute>(zeroPoint);
+        // The same clamping as the SIMD kernels, NaN included
+        result = (result > low) ? result : low;
+        result = (result < high) ? result : high;
+        return static_cast<To>(std::nearbyint(result));
+    }
+
+    double inverseScale;
+    double zeroPoint;
+};
+
+//***************************************************************************
+// makeConvertedView
+//***************************************************************************
+/** \brief Factory method to build a View showing the elements of a
+ * FlatView converted to `To`, e.g. `makeConvertedView<float>(view)`.
+ * To convert a whole View at once, `convert` is faster.
+ * \ingroup user_functions
+ * \param To the type of the elements of the result
+ * \param view the FlatView whose elements are to be converted
+ */
+template <typename To, template<typename> class ScalarPolicy, typename RawIterator>
+auto makeConvertedView(const FlatView<ScalarPolicy, RawIterator>& view)
+    -> TransformedFlatView<ScalarPolicy, RawIterator, ConvertScalar<To>>
+{
+    return makeTransformedFlatView(view, ConvertScalar<To>{});
+}
+
+/** \brief The same, quantizing the elements to the integer type `To`,
+ * e.g. `makeConvertedView<int8_t>(view, Quantization{0.05})`
+ * \param quantization the scale and the zero point of the integers
+ */
+template <typename To, template<typename> class ScalarPolicy, typename RawIterator>
+auto makeConvertedView(const FlatView<ScalarPolicy, RawIterator>& view, Quantization quantization)
+    -> TransformedFlatView<ScalarPolicy, RawIterator, QuantizeScalar<To>>
+{
+    return makeTransformedFlatView(view, QuantizeScalar<To>{quantization});
+}
+
+//***************************************************************************
+// ConvertKernel
+//***************************************************************************
+/** \brief Applies a conversion function to `count` contiguous elements.
+ * The generic version is a plain loop, left to the auto-vectorizer;
+ * the specializations use SIMD instructions for the most common
+ * narrowings and widenings.
+ * \ingroup detail
+ */
+template <typename From, typename To, typename Function>
+struct ConvertKernel {
+    static void apply(const From* in, size_t count, To* out, const Function& function) {
+        for (size_t i = 0; i < count; ++i) out[i] = function(in[i]);
+    }
+};
+
+#ifdef __SSE2__
+
+// double -> float, 4 at a time
+template <>
+struct ConvertKernel<double, float, ConvertScalar<float>> {
+    static void apply(const double* in, size_t count, float* out, const ConvertScalar<float>& function) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m128 low = _mm_cvtpd_ps(_mm_loadu_pd(in + i));
+            const __m128 high = _mm_cvtpd_ps(_mm_loadu_pd(in + i + 2));
+            _mm_storeu_ps(out + i, _mm_movelh_ps(low, high));
+        }
+        for (; i < count; ++i) out[i] = function(in[i]);
+    }
+};
+
+// float -> double, 4 at a time
+template <>
+struct ConvertKernel<float, double, ConvertScalar<double>> {
+    static void apply(const float* in, size_t count, double* out, const ConvertScalar<double>& function) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m128 values = _mm_loadu_ps(in + i);
+            _mm_storeu_pd(out + i, _mm_cvtps_pd(values));
+            _mm_storeu_pd(out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(values, values)));
+        }
+        for (; i < count; ++i) out[i] = function(in[i]);
+    }
+};
+
+// Quantizes 4 floats to 32-bit integers, as QuantizeScalar does
+inline __m128i quantizeFloats(
+    const float* in, __m128 inverseScale, __m128 zeroPoint, __m128 low, __m128 high
+) {
+    __m128 values = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in), inverseScale), zeroPoint);
+    values = _mm_min_ps(_mm_max_ps(values, low), high);
+    return _mm_cvtps_epi32(values); // rounding to nearest, halfway cases to even
+}
+
+inline __m128i packQuantized(__m128i first, __m128i second, std::true_type /*isSigned*/) {
+    return _mm_packs_epi16(first, second);
+}
+inline __m128i packQuantized(__m128i first, __m128i second, std::false_type /*isSigned*/) {
+    return _mm_packus_epi16(first, second);
+}
+
+// float -> 8-bit integers, 16 at a time
+template <typename To>
+struct QuantizeBytesKernel {
+    static void apply(const float* in, size_t count, To* out, const QuantizeScalar<To>& function) {
+        const __m128 inverseScale = _mm_set1_ps(static_cast<float>(function.inverseScale));
+        const __m128 zeroPoint = _mm_set1_ps(static_cast<float>(function.zeroPoint));
+        const __m128 low = _mm_set1_ps(static_cast<float>(std::numeric_limits<To>::lowest()));
+        const __m128 high = _mm_set1_ps(static_cast<float>(std::numeric_limits<To>::max()));
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            // The values are already clamped, so the saturations are exact
+            const __m128i a = quantizeFloats(in + i, inverseScale, zeroPoint, low, high);
+            const __m128i b = quantizeFloats(in + i + 4, inverseScale, zeroPoint, low, high);
+            const __m128i c = quantizeFloats(in + i + 8, inverseScale, zeroPoint, low, high);
+            const __m128i d = quantizeFloats(in + i + 12, inverseScale, zeroPoint, low, high);
+            const __m128i bytes = packQuantized(
+                _mm_packs_epi32(a, b), _mm_packs_epi32(c, d),
+                std::integral_constant<bool, std::is_signed<To>::value>{}
+            );
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bytes);
+        }
+        for (; i < count; ++i) out[i] = function(in[i]);
+    }
+};
+
+template <>
+struct ConvertKernel<float, int8_t, QuantizeScalar<int8_t>> : QuantizeBytesKernel<int8_t> {};
+template <>
+struct ConvertKernel<float, uint8_t, QuantizeScalar<uint8_t>> : QuantizeBytesKernel<uint8_t> {};
+
+#endif // __SSE2__
+
+//***************************************************************************
+// convertSegment
+//***************************************************************************
+// Provides `value` = true if Output is a contiguous iterator on To
+// (the check is skipped for output-only iterators, whose value_type is void)
+template <
+    typename Output,
+    typename To,
+    bool = std::is_same<typename std::iterator_traits<Output>::value_type, To>::value
+>
+struct IsContiguousOutput : std::false_type {};
+template <typename Output, typename To>
+struct IsContiguousOutput<Output, To, true> :
+    std::integral_constant<bool, IsContiguousIterator<Output>::value> {};
+
+// Version for contiguous input and output: the kernels
+template <typename To, typename Iterator, typename Output, typename Function>
+Output convertSegment(Iterator first, size_t count, Output out, const Function& function, std::true_type) {
+    using From = typename std::iterator_traits<Iterator>::value_type;
+    ConvertKernel<From, To, Function>::apply(std::addressof(*first), count, std::addressof(*out), function);
+    return out + static_cast<typename std::iterator_traits<Output>::difference_type>(count);
+}
+
+// Version for other iterators: a plain loop
+template <typename To, typename Iterator, typename Output, typename Function>
+Output convertSegment(Iterator first, size_t count, Output out, const Function& function, std::false_type) {
+    for (size_t i = 0; i < count; ++i, ++first, ++out) *out = function(*first);
+    return out;
+}
+
+template <typename To, typename Iterator, typename Output, typename Function>
+Output convertSegment(Iterator first, size_t count, Output out, const Function& function) {
+    return convertSegment<To>(first, count, out, function, std::integral_constant<bool,
+           IsContiguousIterator<Iterator>::value
+        && IsContiguousOutput<Output, To>::value
+    >{});
+}
+
+// Converts a FlatView or TransformedFlatView a segment at a time, see convert
+template <typename To, typename View, typename Output, typename Function>
+Output convertView(const View& view, Output out, const Function& function) {
+    forEachSegment(view, [&](typename View::const_iterator::SegmentIterator first, size_t count) {
+        out = convertSegment<To>(first, count, out, function);
+    });
+    return out;
+}
+
+//***************************************************************************
+// ConvertVisitor
+//***************************************************************************
+// Receives the runs of BoxedView::visitDense, converting them to the output
+template <typename To, typename Output, typename Function>
+struct ConvertVisitor {
+    template <typename Iterator>
+    void segment(Iterator first, size_t count) {
+        out = convertSegment<To>(first, count, out, function);
+    }
+    template <typename ScalarType>
+    void padding(const ScalarType& defaultValue, size_t count) {
+        out = std::fill_n(out, count, static_cast<To>(function(defaultValue)));
+    }
+
+    Output out;
+    const Function& function;
+};
+
+// The target type: To, or else the value_type of the output
+template <typename To, typename Output>
+struct ConvertTarget {
+    using type = typename std::conditional<
+        std::is_void<To>::value,
+        typename std::iterator_traits<Output>::value_type,
+        To
+    >::type;
+    static_assert(
+        !std::is_void<type>::value,
+        "convert : the target type must be given for output iterators without a value_type"
+    );
+};
+
+//***************************************************************************
+// convert
+//***************************************************************************
+/** \brief Writes the elements of a FlatView, converted to `To`,
+ * to the range beginning at `out`, e.g.
+ * `convert(makeFlatView(nested), floats.begin())`.
+ * The View is processed by segments: when both a segment and the output
+ * are contiguous, vectorized kernels are used
+ * (SSE2 for double <-> float and for the quantization of floats to bytes).
+ * \ingroup user_functions
+ * \param To (optional) the target type; by default, the `value_type`
+ *  of the output (it must be given for output-only iterators,
+ *  e.g. `convert<float>(view, std::back_inserter(floats))`)
+ * \param view the FlatView to be converted
+ * \param out the beginning of the destination range
+ * \return the end of the destination range
+ */
+template <
+    typename To = void,
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename RawIterator = void,
+    typename Output = void
+>
+Output convert(const FlatView<ScalarPolicy, RawIterator>& view, Output out) {
+    using Target = typename ConvertTarget<To, Output>::type;
+    return convertView<Target>(view, out, ConvertScalar<Target>{});
+}
+
+/** \brief The same, quantizing the elements to the integer type `To`
+ * (e.g. `int8_t`), see `Quantization`
+ * \param quantization the scale and the zero point of the integers
+ */
+template <
+    typename To = void,
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename RawIterator = void,
+    typename Output = void
+>
+Output convert(const FlatView<ScalarPolicy, RawIterator>& view, Output out, Quantization quantization) {
+    using Target = typename ConvertTarget<To, Output>::type;
+    return convertView<Target>(view, out, QuantizeScalar<Target>{quantization});
+}
+
+/** \brief The same, on the elements of a TransformedFlatView
+ * (e.g. a projection, see FlatView::project). Its segments are not
+ * contiguous, so they are converted with a plain loop.
+ */
+template <
+    typename To = void,
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename RawIterator = void,
+    typename Function = void,
+    typename Output = void
+>
+Output convert(const TransformedFlatView<ScalarPolicy, RawIterator, Function>& view, Output out) {
+    using Target = typename ConvertTarget<To, Output>::type;
+    return convertView<Target>(view, out, ConvertScalar<Target>{});
+}
+
+/** \brief The same, quantizing the elements of a TransformedFlatView */
+template <
+    typename To = void,
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename RawIterator = void,
+    typename Function = void,
+    typename Output = void
+>
+Output convert(
+    const TransformedFlatView<ScalarPolicy, RawIterator, Function>& view, Output out,
+    Quantization quantization
+) {
+    using Target = typename ConvertTarget<To, Output>::type;
+    return convertView<Target>(view, out, QuantizeScalar<Target>{quantization});
+}
+
+/** \brief Writes the whole box of a BoxedView, converted to `To`,
+ * in row-major order. The physical runs are converted as for FlatViews,
+ * and the padding is written in bulk with the converted default value.
+ */
+template <
+    typename To = void,
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename RawIterator = void,
+    size_t dimensionality = 0,
+    typename Output = void
+>
+Output convert(const BoxedView<ScalarPolicy, RawIterator, dimensionality>& view, Output out) {
+    using Target = typename ConvertTarget<To, Output>::type;
+    const ConvertScalar<Target> function{};
+    ConvertVisitor<Target, Output, ConvertScalar<Target>> visitor{out, function};
+    view.visitDense(visitor);
+    return visitor.out;
+}
+
+/** \brief The same, quantizing the elements to the integer type `To` */
+template <
+    typename To = void,
+    template<typename> class ScalarPolicy = NoCustomScalars,
+    typename RawIterator = void,
+    size_t dimensionality = 0,
+    typename Output = void
+>
+Output convert(
+    const BoxedView<ScalarPolicy, RawIterator, dimensionality>& view, Output out,
+    Quantization quantization
+) {
+    using Target = typename ConvertTarget<To, Output>::type;
+    const QuantizeScalar<Target> function{quantization};
+    ConvertVisitor<Target, Output, QuantizeScalar<Target>> visitor{out, function};
+    view.visitDense(visitor);
+    return visitor.out;
+}
+
+} // namespace multidim - Convert
+
 #endif // MULTIDIM_H
 
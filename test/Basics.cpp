@@ -8,7 +8,7 @@
 
 #include "catch.hpp"
 
-#include "../Basics.h"
+#include "../multidim.hpp"
 
 namespace md = multidim;
 using std::vector;
@@ -123,6 +123,46 @@ TEST_CASE( "Basics", "[multidim]" ) {
         // (*) the last index should maybe be 5, but it's a moot point as the object cannot be filled,
         // see http://stackoverflow.com/questions/11044304/can-i-push-an-array-of-int-to-a-c-vector
     }
+
+    SECTION( "parallelBounds") {
+        vector<vector<int>> jaggedLastDimension = {{1,2,3},{4,5}};
+        vector<vector<int>> manyRows(1000);
+        for (size_t i = 0; i < manyRows.size(); ++i) manyRows[i].resize(i % 10);
+        md::SerialExecutor serial;
+
+        CHECK(md::parallelBounds(vectorInt) == md::bounds(vectorInt));
+        CHECK(md::parallelBounds(cArray) == md::bounds(cArray));
+        CHECK(md::parallelBounds(table) == md::bounds(table));
+        CHECK(md::parallelBounds<md::StringsAsScalars>(table) == md::bounds<md::StringsAsScalars>(table));
+        CHECK(md::parallelBounds(riddled) == md::bounds(riddled));
+        CHECK(md::parallelBounds(begin(riddled), begin(riddled)+2, serial) == (vector<size_t> {2, 5, 2}));
+        CHECK(md::parallelBounds(vecVecBool) == md::bounds(vecVecBool));
+        CHECK(md::parallelBounds(jaggedLastDimension) == md::bounds(jaggedLastDimension));
+        CHECK(md::parallelBounds(manyRows) == (vector<size_t> {1000, 9}));
+
+        vector<md::BoundsStatistics> statistics;
+        md::parallelBounds(riddled, serial, &statistics);
+        REQUIRE(statistics.size() == 3);
+        CHECK(statistics[0].averageLength == 5);
+        CHECK(statistics[0].p99Length == 5);
+        CHECK(statistics[0].paddingRatio == 0);
+        CHECK(statistics[1].averageLength == 9.0/5);  // {5, 0, 1, 1, 2}
+        CHECK(statistics[1].p99Length == 5);
+        CHECK(statistics[1].paddingRatio == 1.0 - 9.0/25);
+        CHECK(statistics[2].averageLength == 7.0/9);
+        CHECK(statistics[2].p99Length == 2);
+        CHECK(statistics[2].paddingRatio == 1.0 - 7.0/50);
+
+        md::parallelBounds(manyRows, md::defaultExecutor(), &statistics);
+        REQUIRE(statistics.size() == 2);
+        CHECK(statistics[1].averageLength == 4.5);
+        CHECK(statistics[1].p99Length == 9);
+        CHECK(statistics[1].paddingRatio == 0.5);
+        manyRows[0].resize(1000);    // a single, very long row
+        md::parallelBounds(manyRows, md::defaultExecutor(), &statistics);
+        CHECK(statistics[1].p99Length == 9);
+        CHECK(statistics[1].paddingRatio > 0.99);
+    }
 }
 
 
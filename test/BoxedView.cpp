@@ -213,4 +213,228 @@ TEST_CASE( "BoxedView", "[multidim]" ) {
         CHECK(std::distance(begin(bv[0][0]), end(bv[0][0])) == 4);
 
     }
+    SECTION("Bounds statistics") {
+        vector<vector<int>> uriahFuller = {{},{1,2,3,},{4},{},{},{5,6}};
+        vector<md::BoundsStatistics> statistics;
+
+        auto bv = md::makeBoxedView(uriahFuller, 0, {}, &statistics);
+        CHECK(std::distance(begin(bv[0]), end(bv[0])) == 3);
+        REQUIRE(statistics.size() == 2);
+        CHECK(statistics[1].averageLength == 1);
+        CHECK(statistics[1].p99Length == 3);
+        CHECK(statistics[1].paddingRatio == 1.0 - 6.0/18);
+
+        // Statistics are computed also if the bounds are given
+        statistics.clear();
+        auto bv2 = md::makeBoxedView(uriahFuller, 0, {6, 2}, &statistics);
+        CHECK(std::distance(begin(bv2[0]), end(bv2[0])) == 2);
+        CHECK(statistics.size() == 2);
+
+        // Bounds computed on the caller's executor
+        md::ThreadPoolExecutor pool{2};
+        vector<vector<int>> rows(100);
+        for (size_t i = 0; i < rows.size(); ++i) rows[i].resize(i % 7);
+        auto bv3 = md::makeBoxedView(rows, 0, {}, pool);
+        CHECK(bv3.viewBounds() == md::bounds(rows));
+        statistics.clear();
+        auto bv4 = md::makeBoxedView(rows.begin(), rows.end(), 0, {}, pool, &statistics);
+        CHECK(bv4.viewBounds() == (vector<size_t> {100, 6}));
+        REQUIRE(statistics.size() == 2);
+        CHECK(statistics[1].p99Length == 6);
+    }
+    SECTION("bucketByLength") {
+        vector<vector<int>> sequences = {{1,2},{3,4,5,6,7,8},{},{9},{10,11,12,13,14,15,16,17,18,19}};
+
+        auto buckets = md::bucketByLength(sequences, {2, 6}, -1);
+        REQUIRE(buckets.size() == 3);
+
+        // Bucket 0: rows 0, 2, 3, padded to length 2
+        CHECK(buckets.indices(0) == (vector<size_t> {0, 2, 3}));
+        CHECK(buckets[0].size() == 3);
+        CHECK(std::distance(begin(buckets[0][0]), end(buckets[0][0])) == 2);
+        CHECK(buckets[0][0][1] == 2);
+        CHECK(buckets[0][1][0] == -1);
+        CHECK(buckets[0][2][0] == 9);
+        CHECK(buckets[0][2][1] == -1);
+
+        // Bucket 1: row 1, padded to length 6
+        CHECK(buckets.indices(1) == (vector<size_t> {1}));
+        CHECK(std::distance(begin(buckets[1][0]), end(buckets[1][0])) == 6);
+
+        // Bucket 2: rows longer than 6
+        CHECK(buckets.indices(2) == (vector<size_t> {4}));
+        CHECK(buckets[2][0][9] == 19);
+
+        // Inverse permutation
+        CHECK(buckets.location(3) == (std::pair<size_t, size_t> {0, 2}));
+        CHECK(buckets.location(4) == (std::pair<size_t, size_t> {2, 0}));
+
+        // The Views survive a move, and write to the original container
+        auto moved = std::move(buckets);
+        moved[0][2][0] = 99;
+        CHECK(sequences[3][0] == 99);
+
+        // Empty buckets
+        auto buckets2 = md::bucketByLength(sequences, {0, 1, 100});
+        CHECK(buckets2.size() == 4);
+        CHECK(buckets2[3].size() == 0);
+        CHECK(buckets2[2].size() == 3);
+
+        CHECK_THROWS(md::bucketByLength(sequences, {6, 2}));
+    }
+    SECTION("split") {
+        const vector<vector<int>> uriahFuller = {{},{1,2,3,},{4},{},{},{5,6}};
+        auto bv = md::makeBoxedView(uriahFuller, 0, {8,2});  // bv appears as a int[8][2]
+
+        auto parts = bv.split(3);
+        REQUIRE(parts.size() == 3);
+        CHECK(parts[0].size() == 2);
+        CHECK(parts[1].size() == 3);
+        CHECK(parts[2].size() == 3);
+        CHECK(parts[0][1][1] == 2);
+        CHECK(parts[1][0][0] == 4);
+        CHECK(parts[2][0][1] == 6);
+        CHECK(parts[2][2][0] == 0);     // physically absent
+        CHECK_THROWS(parts[2][3]);
+        CHECK(std::distance(begin(parts[2][0]), end(parts[2][0])) == 2);
+
+        // More parts than elements: some parts are empty
+        auto smallParts = bv.split(10);
+        size_t totalSize = 0;
+        for (auto& part : smallParts) totalSize += part.size();
+        CHECK(totalSize == 8);
+
+        CHECK_THROWS(bv.split(0));
+    }
+    SECTION("toCoo") {
+        const vector<vector<int>> uriahFuller = {{},{1,0,3,},{4},{},{},{5,6}};
+        auto bv = md::makeBoxedView(uriahFuller, 0, {8,2});  // bv appears as a int[8][2]
+
+        auto coo = bv.toCoo();
+        REQUIRE(coo.size() == 4);   // 3 is out of bounds, 0 is the default value
+        CHECK(coo.indices[0] == (vector<size_t>{1, 2, 5, 5}));
+        CHECK(coo.indices[1] == (vector<size_t>{0, 0, 0, 1}));
+        CHECK(coo.values == (vector<int>{1, 4, 5, 6}));
+
+        // Parallel
+        vector<vector<vector<int>>> grid(1000);
+        for (size_t i = 0; i < grid.size(); i += 3) {
+            grid[i].resize(i % 5);
+            for (auto& row : grid[i]) row.assign(i % 7, static_cast<int>(i % 4));
+        }
+        md::ThreadPoolExecutor executor{4};
+        auto gridView = md::makeBoxedView(grid, 0, {});
+        auto parallelCoo = gridView.toCoo(executor);
+        md::SerialExecutor serial;
+        auto sequentialCoo = gridView.toCoo(serial);
+        size_t nonDefault = 0;
+        for (auto&& plane : gridView) for (auto&& row : plane) for (auto&& cell : row) if (cell != 0) ++nonDefault;
+        CHECK(parallelCoo.size() == nonDefault);
+        CHECK(parallelCoo.values == sequentialCoo.values);
+        CHECK(parallelCoo.indices == sequentialCoo.indices);
+        for (size_t n = 0; n < parallelCoo.size(); n += 17) {
+            CHECK(grid[parallelCoo.indices[0][n]][parallelCoo.indices[1][n]][parallelCoo.indices[2][n]] == parallelCoo.values[n]);
+        }
+
+        // Parts of a split view keep the indices relative to the part
+        auto parts = bv.split(2);
+        CHECK(parts[1].toCoo().indices[0] == (vector<size_t>{1, 1}));
+    }
+    SECTION("Morton order") {
+        using Index2 = std::array<size_t, 2>;
+        using Index3 = std::array<size_t, 3>;
+        CHECK(md::mortonEncode(Index2{{0, 1}}) == 1);
+        CHECK(md::mortonEncode(Index2{{1, 0}}) == 2);
+        CHECK(md::mortonEncode(Index2{{3, 5}}) == 27);
+        CHECK(md::mortonEncode(Index3{{1, 1, 1}}) == 7);
+        for (uint64_t code = 0; code < 5000; code += 37) {
+            CHECK(md::mortonEncode(md::mortonDecode<2>(code)) == code);
+            CHECK(md::mortonEncode(md::mortonDecode<3>(code)) == code);
+            CHECK(md::mortonEncode(md::mortonDecode<4>(code)) == code);
+        }
+        CHECK(md::mortonDecode<2>(md::mortonEncode(Index2{{123456, 654321}})) == (Index2{{123456, 654321}}));
+
+        vector<vector<int>> uriahFuller = {{},{1,2,3,},{4},{},{},{5,6}};
+        auto bv = md::makeBoxedView(uriahFuller, 0, {});   // int[6][3]
+
+        vector<Index2> visited;
+        vector<int> values;
+        md::forEachMorton(bv, [&](const Index2& index, int value) {
+            visited.push_back(index);
+            values.push_back(value);
+        });
+        REQUIRE(visited.size() == 18);
+        CHECK(visited[0] == (Index2{{0, 0}}));
+        CHECK(visited[1] == (Index2{{0, 1}}));
+        CHECK(visited[2] == (Index2{{1, 0}}));
+        CHECK(visited[3] == (Index2{{1, 1}}));
+        CHECK(visited[4] == (Index2{{0, 2}}));   // (0, 3) is out of bounds
+        CHECK(values[3] == 2);
+        for (size_t i = 1; i < visited.size(); ++i) {
+            CHECK(md::mortonEncode(visited[i - 1]) < md::mortonEncode(visited[i]));
+        }
+
+        // Elements can be written through the view
+        using Proxy = decltype(bv[0][0]);
+        md::forEachMorton(bv, [](const Index2& index, Proxy value) {
+            if (index[0] == 5 && index[1] == 1) value = 66;
+        });
+        CHECK(uriahFuller[5][1] == 66);
+
+        auto morton = md::makeMortonArray(uriahFuller, -1);
+        CHECK(md::bounds(morton) == (vector<size_t>{6, 3}));
+        CHECK(morton.size() == 18);
+        CHECK(morton[(Index2{{1, 2}})] == 3);
+        CHECK(morton[(Index2{{5, 1}})] == 66);
+        CHECK(morton[(Index2{{0, 0}})] == -1);
+        CHECK_THROWS(morton.at(Index2{{6, 0}}));
+        CHECK(morton.storage()[morton.position(Index2{{2, 0}})] == 4);
+        size_t count = 0;
+        morton.forEach([&](const Index2&, int& value) {++value; ++count;});
+        CHECK(count == 18);
+        CHECK(morton[(Index2{{0, 0}})] == 0);
+        CHECK_THROWS((md::MortonArray<int, 2>(Index2{{size_t{1} << 33, 1}})));
+
+        // Skewed bounds: each dimension contributes only its own bits
+        md::MortonArray<int, 2> skewed{Index2{{100000, 3}}, 7};
+        CHECK(skewed.size() == 300000);
+        CHECK(skewed.storage().size() < 2 * 131072 * 2);
+        skewed[(Index2{{99999, 2}})] = 1;
+        skewed[(Index2{{50000, 1}})] = 2;
+        CHECK(skewed.at(Index2{{99999, 2}}) == 1);
+        CHECK(skewed[(Index2{{50000, 1}})] == 2);
+        CHECK(skewed[(Index2{{50000, 2}})] == 7);
+        size_t previous = 0;
+        size_t unordered = 0;
+        count = 0;
+        skewed.forEach([&](const Index2& index, int&) {
+            const size_t position = skewed.position(index);
+            if (count > 0 && position <= previous) ++unordered;
+            previous = position;
+            ++count;
+        });
+        CHECK(count == 300000);
+        CHECK(unordered == 0);
+        CHECK(previous == skewed.storage().size() - 1);
+
+        md::MortonArray<int, 3> thin{std::array<size_t, 3>{{1, 1 << 20, 2}}};
+        CHECK(thin.storage().size() == (size_t{2} << 20));
+    }
+    SECTION("Conversion") {
+        vector<vector<double>> doubles = {{1.5, 2.5}, {}, {3, 4, 5, 6, 7}};
+        auto bv = md::makeBoxedView(doubles, -1.0, {4, 3});
+        vector<float> floats(12);
+        CHECK(md::convert(bv, floats.begin()) == floats.end());
+        CHECK(floats == (vector<float>{1.5, 2.5, -1, -1, -1, -1, 3, 4, 5, -1, -1, -1}));
+
+        vector<int8_t> bytes;
+        md::convert<int8_t>(bv, std::back_inserter(bytes), md::Quantization{0.5});
+        CHECK((vector<int>(bytes.begin(), bytes.end())) == (vector<int>{3, 5, -2, -2, -2, -2, 6, 8, 10, -2, -2, -2}));
+
+        vector<vector<vector<int>>> nested = {{{1}, {2, 3}}};
+        auto deep = md::makeBoxedView(nested, 0, {2, 2, 2});
+        vector<double> widened;
+        md::convert<double>(deep, std::back_inserter(widened));
+        CHECK(widened == (vector<double>{1, 0, 2, 3, 0, 0, 0, 0}));
+    }
 }
@@ -0,0 +1,89 @@
+﻿// This ﬁle is encoded in UTF-8.
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "catch.hpp"
+
+#include "../multidim.hpp"
+
+namespace md = multidim;
+using std::vector;
+
+// **************************************************************************
+
+TEST_CASE( "ConcurrentJagged", "[multidim]" ) {
+    SECTION("Publication") {
+        md::ConcurrentJagged<int> jagged;
+        CHECK(jagged.pushBack({1, 2}) == 0);
+
+        const size_t first = jagged.reserveRow();
+        const size_t second = jagged.reserveRow();
+        jagged.row(second).push_back(4);
+        jagged.publish(second);
+        // the first row is still private: the prefix ends before it
+        CHECK(jagged.publishedSize() == 1);
+        CHECK(jagged.reservedSize() == 3);
+
+        jagged.row(first).push_back(3);
+        auto before = jagged.view();
+        jagged.publish(first);
+        auto after = jagged.view();
+        CHECK(before.size() == 1);
+        REQUIRE(after.size() == 3);
+        CHECK(after[1] == (vector<int>{3}));
+
+        auto fv = md::makeFlatView(after);
+        CHECK((vector<int>(fv.begin(), fv.end())) == (vector<int>{1, 2, 3, 4}));
+        CHECK(md::bounds(after) == (vector<size_t>{3, 2}));
+
+        // Rows are not relocated by the following appends
+        const int* address = &after[0][0];
+        for (int i = 0; i < 1000; ++i) jagged.pushBack(vector<int>(static_cast<size_t>(i % 4), i));
+        CHECK(&jagged.view()[0][0] == address);
+        CHECK(jagged.view().size() == 1003);
+        CHECK(jagged.view()[1002] == (vector<int>(3, 999)));
+    }
+    SECTION("Concurrent producers") {
+        md::ConcurrentJagged<size_t> jagged;
+        constexpr size_t producerCount = 4;
+        constexpr size_t rowsPerProducer = 5000;
+        std::atomic<size_t> badViews{0};
+        std::atomic<bool> done{false};
+
+        // Each row holds (producer, length, ...), so readers can check it
+        std::thread reader([&] {
+            while (!done) {
+                auto view = jagged.view();
+                for (const auto& row : view) {
+                    if (row.size() < 2 || row.size() != row[1]) ++badViews;
+                }
+            }
+        });
+        vector<std::thread> producers;
+        for (size_t p = 0; p < producerCount; ++p) {
+            producers.emplace_back([&jagged, p] {
+                for (size_t i = 0; i < rowsPerProducer; ++i) {
+                    const size_t index = jagged.reserveRow();
+                    auto& row = jagged.row(index);
+                    row.push_back(p);
+                    row.push_back(2 + i % 5);
+                    row.resize(2 + i % 5, i);
+                    jagged.publish(index);
+                }
+            });
+        }
+        for (auto& producer : producers) producer.join();
+        done = true;
+        reader.join();
+
+        CHECK(badViews == 0);
+        auto view = jagged.view();
+        REQUIRE(view.size() == producerCount * rowsPerProducer);
+        vector<size_t> rowsByProducer(producerCount, 0);
+        for (const auto& row : view) ++rowsByProducer.at(row[0]);
+        CHECK(rowsByProducer == vector<size_t>(producerCount, rowsPerProducer));
+    }
+}
@@ -0,0 +1,130 @@
+﻿// This ﬁle is encoded in UTF-8.
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <numeric>
+
+#include "catch.hpp"
+
+#include "../multidim.hpp"
+
+namespace md = multidim;
+using std::vector;
+
+// **************************************************************************
+
+TEST_CASE( "CowContainer", "[multidim]" ) {
+    SECTION("Snapshots") {
+        md::CowContainer<vector<int>> rows{{{1, 2}, {}, {3}}};
+        auto before = rows.snapshot();
+
+        rows.mutableRow(0)[1] = 22;
+        rows.pushBack({4, 5, 6});
+        rows.assignRow(1, {7});
+        CHECK(rows[0] == (vector<int>{1, 22}));
+        CHECK(rows.size() == 4);
+        CHECK_THROWS(rows.mutableRow(4));
+
+        // The snapshot is not affected by the following modifications
+        REQUIRE(before.size() == 3);
+        CHECK(before[0] == (vector<int>{1, 2}));
+        CHECK(before[1].empty());
+        auto fv = md::makeFlatView(before);
+        CHECK((vector<int>(fv.begin(), fv.end())) == (vector<int>{1, 2, 3}));
+
+        auto after = rows.snapshot();
+        auto bv = md::makeBoxedView(after, 0, {});
+        CHECK(md::bounds(after) == (vector<size_t>{4, 3}));
+        CHECK(bv[0][1] == 22);
+        CHECK(bv[1][0] == 7);
+        CHECK(bv[3][2] == 6);
+
+        // Untouched rows are shared, not copied
+        CHECK(&before[2] == &after[2]);
+        CHECK(&before[0] != &after[0]);
+    }
+    SECTION("Copies") {
+        md::CowContainer<vector<int>> a{{{1}, {2}}};
+        for (int i = 0; i < 100; ++i) a.pushBack({i});
+        auto b = a;
+        b.mutableRow(0).push_back(99);
+        b.pushBack({7});
+        CHECK(a[0] == (vector<int>{1}));
+        CHECK(a.size() == 102);
+        CHECK(b[0] == (vector<int>{1, 99}));
+        CHECK(b.size() == 103);
+
+        // Both ways, and through assignment
+        a.mutableRow(50).push_back(-1);
+        CHECK(b[50] == (vector<int>{48}));
+        md::CowContainer<vector<int>> c;
+        c = a;
+        c.assignRow(1, {});
+        a.mutableRow(1).push_back(3);
+        CHECK(c[1].empty());
+        CHECK(a[1] == (vector<int>{2, 3}));
+        CHECK(c[50] == (vector<int>{48, -1}));
+        CHECK(&b[2] == &c[2]);   // still shared
+    }
+    SECTION("Large") {
+        md::CowContainer<vector<int>> rows;
+        for (int i = 0; i < 5000; ++i) rows.pushBack(vector<int>(static_cast<size_t>(i % 3), i));
+        auto first = rows.snapshot();
+        for (size_t i = 0; i < rows.size(); i += 7) rows.mutableRow(i).push_back(-1);
+        auto second = rows.snapshot();
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < first.size(); ++i) {
+            const size_t length = i % 3;
+            if (first[i].size() != length) ++mismatches;
+            if (second[i].size() != length + (i % 7 == 0 ? 1 : 0)) ++mismatches;
+            if ((i % 7 != 0) && &first[i] != &second[i]) ++mismatches;
+        }
+        CHECK(mismatches == 0);
+        CHECK(md::scalarSize(first) == 4999);
+        CHECK(std::distance(first.begin(), first.end()) == 5000);
+        CHECK(first.end() - first.begin() == 5000);
+    }
+    SECTION("Concurrent readers") {
+        md::CowContainer<vector<int>> rows;
+        for (int i = 0; i < 200; ++i) rows.pushBack(vector<int>(10, 1));
+
+        std::mutex mutex;
+        auto published = rows.snapshot();
+        std::atomic<bool> done{false};
+        std::atomic<size_t> badSums{0};
+
+        vector<std::thread> readers;
+        for (int r = 0; r < 4; ++r) {
+            readers.emplace_back([&] {
+                while (!done) {
+                    md::CowSnapshot<vector<int>> snapshot;
+                    {
+                        std::lock_guard<std::mutex> lock{mutex};
+                        snapshot = published;
+                    }
+                    // the writer keeps the sum of each snapshot at 2000
+                    auto fv = md::makeFlatView(snapshot);
+                    if (std::accumulate(fv.begin(), fv.end(), 0) != 2000) ++badSums;
+                }
+            });
+        }
+        for (int step = 0; step < 2000; ++step) {
+            const size_t from = static_cast<size_t>(step * 7) % 200;
+            const size_t to = static_cast<size_t>(step * 13 + 1) % 200;
+            if (from != to) {
+                rows.mutableRow(from)[0] -= 1;
+                rows.mutableRow(to)[0] += 1;
+            }
+            auto snapshot = rows.snapshot();
+            std::lock_guard<std::mutex> lock{mutex};
+            published = snapshot;
+        }
+        done = true;
+        for (auto& reader : readers) reader.join();
+        CHECK(badSums == 0);
+    }
+}
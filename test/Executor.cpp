@@ -0,0 +1,135 @@
+﻿// This ﬁle is encoded in UTF-8.
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+
+#include "catch.hpp"
+
+#include "../multidim.hpp"
+
+namespace md = multidim;
+using std::vector;
+
+// **************************************************************************
+// Helper functions
+// Runs 1000 tasks, each one writing its index in a slot
+bool runsAllTasks(md::Executor& executor) {
+    vector<size_t> slots(1000, 0);
+    executor.bulkExecute(slots.size(), [&slots](size_t i){slots[i] = i + 1;});
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i] != i + 1) return false;
+    }
+    return true;
+}
+
+bool propagatesExceptions(md::Executor& executor) {
+    try {
+        executor.bulkExecute(100, [](size_t i){
+            if (i == 42) throw std::runtime_error("task 42");
+        });
+    } catch (std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// **************************************************************************
+
+TEST_CASE( "Executor", "[multidim]" ) {
+    SECTION("SerialExecutor") {
+        md::SerialExecutor executor;
+        CHECK(executor.concurrency() == 1);
+        CHECK(runsAllTasks(executor));
+        CHECK(propagatesExceptions(executor));
+    }
+    SECTION("ThreadPoolExecutor") {
+        md::ThreadPoolExecutor executor{3};
+        CHECK(executor.concurrency() == 4);
+        CHECK(runsAllTasks(executor));
+        CHECK(propagatesExceptions(executor));
+        CHECK(runsAllTasks(executor)); // still usable after an exception
+
+        // Nested calls must not deadlock
+        std::atomic<size_t> counter{0};
+        executor.bulkExecute(8, [&](size_t) {
+            executor.bulkExecute(8, [&](size_t) {++counter;});
+        });
+        CHECK(counter.load() == 64);
+
+        md::ThreadPoolExecutor noWorkers{0};
+        CHECK(runsAllTasks(noWorkers));
+    }
+    SECTION("FunctionExecutor") {
+        // Adapts a "executor" starting a thread for each job
+        vector<std::thread> threads;
+        std::mutex threadsMutex;
+        md::FunctionExecutor executor{
+            [&](std::function<void()> job) {
+                std::lock_guard<std::mutex> lock{threadsMutex};
+                threads.emplace_back(std::move(job));
+            },
+            3
+        };
+        CHECK(executor.concurrency() == 4);
+        CHECK(runsAllTasks(executor));
+        CHECK(propagatesExceptions(executor));
+        for (auto& thread : threads) thread.join();
+
+        // An executor which never runs the submitted jobs:
+        // the calling thread must complete the tasks
+        vector<std::function<void()>> neverRun;
+        md::FunctionExecutor lazyExecutor{
+            [&](std::function<void()> job) {neverRun.push_back(std::move(job));},
+            2
+        };
+        CHECK(runsAllTasks(lazyExecutor));
+        for (auto& job : neverRun) job(); // late jobs find no work
+
+        // An executor which fails after accepting a job: the tasks are still
+        // completed before the error is reported, so the late job finds no work
+        vector<std::function<void()>> accepted;
+        md::FunctionExecutor failingExecutor{
+            [&](std::function<void()> job) {
+                if (!accepted.empty()) throw std::runtime_error("queue full");
+                accepted.push_back(std::move(job));
+            },
+            3
+        };
+        vector<size_t> slots(100, 0);
+        CHECK_THROWS(failingExecutor.bulkExecute(slots.size(), [&slots](size_t i){slots[i] = i + 1;}));
+        CHECK(slots[99] == 100);
+        CHECK(accepted.size() == 1);
+        for (auto& job : accepted) job();
+    }
+#ifdef _OPENMP
+    SECTION("OpenMPExecutor") {
+        md::OpenMPExecutor executor;
+        CHECK(runsAllTasks(executor));
+        CHECK(propagatesExceptions(executor));
+        bool nestedOk = true;
+        #pragma omp parallel
+        #pragma omp single
+        nestedOk = runsAllTasks(executor);
+        CHECK(nestedOk);
+    }
+#endif
+    SECTION("parallelChunks") {
+        vector<int> data(1003, 1);
+        auto& executor = md::defaultExecutor();
+        const size_t chunkCount = md::parallelChunkCount(executor, data.size(), 100);
+        CHECK(chunkCount >= 1);
+        CHECK(chunkCount <= 10);
+        vector<long> partials(chunkCount, 0);
+        md::parallelChunks(executor, data.size(), chunkCount,
+            [&](size_t chunk, size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) partials[chunk] += data[i];
+            }
+        );
+        long total = 0;
+        for (auto partial : partials) total += partial;
+        CHECK(total == 1003);
+    }
+}
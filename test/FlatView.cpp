@@ -5,10 +5,14 @@
 #include <vector>
 #include <string>
 #include <iterator>  // std::begin
+#include <memory>  // std::unique_ptr
+#include <functional>  // std::greater
+#include <algorithm>  // std::sort
+#include <numeric>  // std::accumulate
 
 #include "catch.hpp"
 
-#include "../FlatView.h"
+#include "../multidim.hpp"
 
 namespace md = multidim;
 using std::vector;
@@ -30,6 +34,10 @@ auto threeWayCopy(const T& fv) -> vector<typename std::remove_const<typename T::
 
 struct NotComparable {public: int a, b; bool operator ==(const NotComparable&)const{return true;}};
 
+struct Point {int x, y;};
+
+struct Particle {float x, y, z; int id;};
+
 // **************************************************************************
 
 TEST_CASE( "FlatView", "[multidim]" ) {
@@ -236,4 +244,389 @@ TEST_CASE( "FlatView", "[multidim]" ) {
         std::remove_if(begin(fv2), end(fv2), [](int n)->bool{return (n%2)==0;});
         CHECK((uriahFuller2[1]) == (vector<int>{1,3,5,}));
     }
+    SECTION("split") {
+        vector<vector<vector<int>>> riddled = {{{1},{},{2,3}},{},{{4,5,6}},{{},{7}}};
+        auto fv = md::makeFlatView(riddled);
+
+        auto parts = fv.split(3);
+        REQUIRE(parts.size() == 3);
+        CHECK(threeWayCopy(parts[0]) == (vector<int> {1,2,2,1,1,2}));
+        CHECK(threeWayCopy(parts[1]) == (vector<int> {3,4,4,3,3,4}));
+        CHECK(threeWayCopy(parts[2]) == (vector<int> {5,6,7,7,6,5,5,6,7}));
+        CHECK(parts[2].size() == 3);
+        CHECK(parts[2][1] == 6);
+
+        // Parts of parts
+        auto subparts = parts[2].split(2);
+        CHECK(threeWayCopy(subparts[0]) == (vector<int> {5,5,5}));
+        CHECK(threeWayCopy(subparts[1]) == (vector<int> {6,7,7,6,6,7}));
+
+        // More parts than elements: some parts are empty
+        size_t nonEmpty = 0;
+        for (auto& part : fv.split(10)) {
+            CHECK(part.size() <= 1);
+            if (!part.empty()) ++nonEmpty;
+        }
+        CHECK(nonEmpty == 7);
+
+        // Parts refer to the original container
+        *(parts[1].begin()) = 33;
+        CHECK(riddled[0][2][1] == 33);
+
+        CHECK_THROWS(fv.split(0));
+    }
+    SECTION("cachePositions and rebuild") {
+        vector<vector<int>> sparseRows(1000);
+        sparseRows.back() = {1, 2};
+        auto fv = md::makeFlatView(sparseRows);
+        auto cached = md::makeFlatView(sparseRows);
+        cached.cachePositions();
+        CHECK(*fv.begin() == 1);
+        CHECK(*cached.begin() == 1);
+        CHECK(cached.size() == 2);
+
+        // by default, begin() and end() follow the changes of the structure
+        sparseRows[10].push_back(9);
+        CHECK((vector<int>(fv.begin(), fv.end())) == (vector<int> {9,1,2}));
+
+        // with cached positions, the View must be rebuilt
+        cached.rebuild();
+        CHECK(threeWayCopy(cached) == (vector<int> {9,1,2,2,1,9,9,1,2}));
+        CHECK(cached.size() == 3);
+    }
+    SECTION("histogram") {
+        vector<vector<double>> samples = {{0.5, 1.5}, {}, {2.5, 2.7, -1, 10}, {0.1}};
+        md::HistogramBins bins;
+        bins.low = 0;
+        bins.high = 3;
+        bins.count = 3;
+        CHECK(md::histogram(md::makeFlatView(samples), bins) == (vector<size_t> {2, 1, 2}));
+
+        md::SerialExecutor serial;
+        md::ThreadPoolExecutor pool{3};
+        vector<vector<int>> big(300);
+        for (size_t i = 0; i < big.size(); ++i) big[i].assign(i % 7, static_cast<int>(i % 10));
+        bins.low = 0;
+        bins.high = 10;
+        bins.count = 5;
+        auto fv = md::makeFlatView(big);
+        auto expected = md::histogram(fv, bins, serial);
+        CHECK(md::histogram(fv, bins, pool) == expected);
+        size_t total = 0;
+        for (size_t n : expected) total += n;
+        CHECK(total == fv.size());
+        CHECK(md::histogram(fv.split(2)[1], bins, pool)[4] <= expected[4]);
+
+        bins.count = 0;
+        CHECK_THROWS(md::histogram(fv, bins));
+
+        // Counting
+        auto isEven = [](int n) {return n % 2 == 0;};
+        auto counts = md::countByRow(big, isEven, pool);
+        REQUIRE(counts.size() == 300);
+        CHECK(counts[4] == 4);
+        CHECK(counts[5] == 0);
+        CHECK(counts == md::countByRow(big, isEven, serial));
+
+        const vector<vector<vector<int>>> riddled = {{{1},{},{2,3}},{},{{4,5,6}}};
+        CHECK(md::countByRow(riddled, isEven) == (vector<size_t> {1, 0, 2}));
+    }
+    SECTION("topK") {
+        vector<vector<vector<int>>> riddled = {{{1},{},{9,3}},{},{{4,9,6}},{{},{7}}};
+        md::ThreadPoolExecutor pool{3};
+
+        auto best = md::topK(riddled, 3, pool);
+        REQUIRE(best.size() == 3);
+        CHECK(best[0].value == 9);
+        CHECK(best[0].indices == (vector<size_t> {0, 2, 0}));
+        CHECK(best[1].indices == (vector<size_t> {2, 0, 1}));
+        CHECK(best[2].value == 7);
+        CHECK(best[2].indices == (vector<size_t> {3, 1, 0}));
+        CHECK(md::topK(riddled, 100).size() == 7);
+        CHECK(md::topK(riddled, 0).empty());
+
+        vector<vector<int>> big(500);
+        for (size_t i = 0; i < big.size(); ++i) {
+            for (size_t j = 0; j < i % 13; ++j) big[i].push_back(static_cast<int>((i * 7919 + j * 104729) % 100003));
+        }
+        vector<int> all;
+        for (auto& row : big) all.insert(all.end(), row.begin(), row.end());
+        std::sort(all.begin(), all.end(), std::greater<int>());
+        auto bigBest = md::topK(big, 20, pool);
+        for (size_t i = 0; i < 20; ++i) {
+            CHECK(bigBest[i].value == all[i]);
+            CHECK(big[bigBest[i].indices[0]][bigBest[i].indices[1]] == all[i]);
+        }
+
+        // Per row
+        auto perRow = md::topKPerRow(riddled, 2, pool);
+        REQUIRE(perRow.size() == 4);
+        REQUIRE(perRow[0].size() == 2);
+        CHECK(perRow[0][0].value == 9);
+        CHECK(perRow[0][1].indices == (vector<size_t> {0, 2, 1}));
+        CHECK(perRow[1].empty());
+        CHECK(perRow[2][1].value == 6);
+        CHECK(perRow[3].size() == 1);
+        CHECK(perRow[3][0].indices == (vector<size_t> {3, 1, 0}));
+    }
+    SECTION("Windows") {
+        vector<vector<int>> chunks = {{1,2,3,4}, {}, {5}, {6,7,8}};
+        auto fv = md::makeFlatView(chunks);
+
+        auto wv = md::makeWindowView(fv, 3);
+        CHECK(wv.size() == 6);
+        vector<vector<int>> windows;
+        vector<bool> inPlace;
+        for (auto window : wv) {
+            windows.emplace_back(window.begin(), window.end());
+            inPlace.push_back(window.begin() >= chunks[0].data() && window.end() <= chunks[0].data() + 4);
+        }
+        CHECK(windows == (vector<vector<int>> {{1,2,3}, {2,3,4}, {3,4,5}, {4,5,6}, {5,6,7}, {6,7,8}}));
+        CHECK(inPlace == (vector<bool> {true, true, false, false, false, false}));
+        auto last = std::next(wv.begin(), 5);
+        CHECK((*last).begin() == chunks[3].data());
+
+        auto strided = md::makeWindowView(fv, 2, 3);
+        windows.clear();
+        for (auto window : strided) windows.emplace_back(window.begin(), window.end());
+        CHECK(windows == (vector<vector<int>> {{1,2}, {4,5}, {7,8}}));
+
+        CHECK(md::makeWindowView(fv, 9).empty());
+        CHECK(md::makeWindowView(fv, 8, 5).size() == 1);
+        CHECK_THROWS(md::makeWindowView(fv, 0));
+
+        // Non contiguous rows: always copied
+        list<list<int>> listChunks = {{1,2}, {3}, {}, {4,5,6}};
+        auto lv = md::makeWindowView(md::makeFlatView(listChunks), 4, 2);
+        windows.clear();
+        for (auto window : lv) windows.emplace_back(window.begin(), window.end());
+        CHECK(windows == (vector<vector<int>> {{1,2,3,4}, {3,4,5,6}}));
+    }
+    SECTION("Filter") {
+        vector<vector<vector<int>>> riddled = {{{1},{},{2,3}},{},{{4,5,6}},{{},{7}}};
+        auto fv = md::makeFlatView(riddled);
+        auto isOdd = [](int n) {return (n % 2) != 0;};
+
+        auto odd = md::makeFilteredFlatView(fv, isOdd);
+        CHECK(vector<int>(odd.begin(), odd.end()) == (vector<int> {1,3,5,7}));
+        CHECK(odd.size() == 4);
+        CHECK(!odd.hasCache());
+
+        // Elements can be modified through the View
+        for (int& n : odd) n *= 10;
+        CHECK(riddled[3][1][0] == 70);
+
+        // Cached positions
+        auto big = md::makeFilteredFlatView(fv, [](int n) {return n > 5;}, true);
+        CHECK(big.hasCache());
+        CHECK(vector<int>(big.begin(), big.end()) == (vector<int> {10,30,50,6,70}));
+        CHECK(big.size() == 5);
+        CHECK(std::next(big.begin(), 3).position() == 5);
+        big.clearCache();
+        CHECK(vector<int>(big.cbegin(), big.cend()) == (vector<int> {10,30,50,6,70}));
+
+        // Filter of a part, of a list, of a View with no survivors
+        auto parts = fv.split(2);
+        auto oddPart = md::makeFilteredFlatView(parts[1], [](int n) {return n < 10;}, true);
+        CHECK(vector<int>(oddPart.begin(), oddPart.end()) == (vector<int> {4,6}));
+
+        list<vector<int>> listOfVectors = {{}, {1,2}, {}, {3}};
+        auto listFiltered = md::makeFilteredFlatView(md::makeFlatView(listOfVectors), isOdd);
+        CHECK(vector<int>(listFiltered.begin(), listFiltered.end()) == (vector<int> {1,3}));
+
+        auto none = md::makeFilteredFlatView(fv, [](int) {return false;}, true);
+        CHECK(none.empty());
+
+        // Cache spanning several words
+        vector<vector<int>> longRows(5, vector<int>(50));
+        for (size_t i = 0; i < 250; ++i) longRows[i/50][i%50] = static_cast<int>(i);
+        auto sparse = md::makeFilteredFlatView(md::makeFlatView(longRows), [](int n) {return (n % 70) == 3;}, true);
+        CHECK(vector<int>(sparse.begin(), sparse.end()) == (vector<int> {3,73,143,213}));
+    }
+    SECTION("Transform") {
+        vector<vector<Point>> points = {{}, {{1,10}, {3,30}}, {}, {{2,20}}};
+        auto fv = md::makeFlatView(points);
+
+        // Projection of a data member, by reference
+        auto xs = fv.project(&Point::x);
+        CHECK(vector<int>(xs.begin(), xs.end()) == (vector<int> {1,3,2}));
+        CHECK(xs.size() == 3);
+        CHECK(xs[2] == 2);
+        std::sort(xs.begin(), xs.end());
+        CHECK(points[1][1].x == 2);
+        CHECK(points[1][1].y == 30);
+
+        const vector<vector<Point>>& constPoints = points;
+        auto ys = md::makeFlatView(constPoints).project(&Point::y);
+        CHECK(vector<int>(ys.cbegin(), ys.cend()) == (vector<int> {10,30,20}));
+        CHECK(*(ys.begin() + 2) == 20);
+
+        // Arbitrary function
+        auto norms = md::makeTransformedFlatView(fv, [](const Point& p) {return p.x * p.x + p.y * p.y;});
+        CHECK(vector<int>(norms.begin(), norms.end()) == (vector<int> {101,904,409}));
+        CHECK(norms.end() - norms.begin() == 3);
+        CHECK(*std::max_element(norms.begin(), norms.end()) == 904);
+
+        // Segments of a projection: those of the underlying View
+        vector<size_t> counts;
+        vector<int> segmentXs;
+        md::forEachSegment(xs, [&](decltype(xs)::const_iterator::SegmentIterator first, size_t count) {
+            counts.push_back(count);
+            for (size_t i = 0; i < count; ++i, ++first) segmentXs.push_back(*first);
+        });
+        CHECK(counts == (vector<size_t> {2, 1}));
+        CHECK(segmentXs == (vector<int> {1,2,3}));
+
+        vector<list<Point>> listedPoints = {{{4,40}}, {}, {{5,50}, {6,60}}};
+        auto listedYs = md::makeFlatView(listedPoints).project(&Point::y);
+        int sum = 0;
+        md::forEachSegment(listedYs, [&](decltype(listedYs)::const_iterator::SegmentIterator first, size_t count) {
+            sum += std::accumulate(first, std::next(first, static_cast<ptrdiff_t>(count)), 0);
+        });
+        CHECK(sum == 150);
+
+        // Algorithms running by segments
+        md::HistogramBins bins;
+        bins.low = 0;
+        bins.high = 30;
+        bins.count = 3;
+        CHECK(md::histogram(ys, bins) == (vector<size_t> {0, 1, 1}));
+        vector<double> doubleXs(3);
+        md::convert(xs, doubleXs.begin());
+        CHECK(doubleXs == (vector<double> {1,2,3}));
+    }
+    SECTION("Extraction") {
+        vector<vector<string>> table = {{"Alpha", "Beta"}, {}, {"Gamma"}};
+
+        // Move-only elements
+        vector<vector<std::unique_ptr<int>>> pointers(3);
+        pointers[0].emplace_back(new int(1));
+        pointers[2].emplace_back(new int(2));
+        pointers[2].emplace_back(new int(3));
+        auto mv = md::makeMoveFlatView(pointers);
+        vector<std::unique_ptr<int>> flatPointers(mv.begin(), mv.end());
+        REQUIRE(flatPointers.size() == 3);
+        CHECK(*flatPointers[2] == 3);
+        CHECK(pointers[2][1] == nullptr);
+
+        // extract appends to the output
+        vector<string> words = {"Zero"};
+        md::extract<md::StringsAsScalars>(table, words);
+        CHECK(words == (vector<string> {"Zero", "Alpha", "Beta", "Gamma"}));
+        CHECK(table.size() == 3);
+        CHECK(table[0].size() == 2);
+
+        vector<vector<string>> table2 = {{"Delta"}, {"Epsilon", "Zeta"}};
+        list<string> wordList;
+        md::extract<md::StringsAsScalars>(table2, wordList, true);
+        CHECK(wordList == (list<string> {"Delta", "Epsilon", "Zeta"}));
+        CHECK(table2.size() == 2);
+        CHECK(table2[1].empty());
+        CHECK(table2[1].capacity() == 0);
+    }
+    SECTION("Struct of arrays") {
+        vector<vector<Particle>> particles = {{{1, 2, 3, 10}, {4, 5, 6, 11}}, {}, {{7, 8, 9, 12}}};
+
+        auto soa = md::toSoa(particles, &Particle::x, &Particle::z, &Particle::id);
+        CHECK(soa.size() == 3);
+        CHECK(soa.lengths == (vector<vector<size_t>>{{2, 0, 1}}));
+        CHECK(soa.column<0>() == (vector<float>{1, 4, 7}));
+        CHECK(soa.column<1>() == (vector<float>{3, 6, 9}));
+        CHECK(soa.column<2>() == (vector<int>{10, 11, 12}));
+
+        auto xs = md::makeReshapedView<2>(soa.column<0>().data(), soa.lengths);
+        CHECK(xs[2][0] == 7);
+        CHECK_THROWS(md::makeReshapedView<3>(soa.column<0>().data(), soa.lengths));
+
+        for (auto& x : soa.column<0>()) x *= 10;
+        md::fromSoa(soa, particles, &Particle::x, &Particle::z, &Particle::id);
+        CHECK(particles[0][1].x == 40);
+        CHECK(particles[0][1].y == 5);     // not in the columns
+        CHECK(particles[2][0].x == 70);
+
+        vector<vector<Particle>> otherShape(2);
+        CHECK_THROWS(md::fromSoa(soa, otherShape, &Particle::x, &Particle::z, &Particle::id));
+
+        // Parallel, deeper
+        vector<vector<vector<Point>>> points(300);
+        int n = 0;
+        for (size_t i = 0; i < points.size(); ++i) {
+            points[i].resize(i % 4);
+            for (auto& row : points[i]) {
+                for (size_t j = 0; j < i % 5; ++j) {row.push_back(Point{n, -n}); ++n;}
+            }
+        }
+        md::ThreadPoolExecutor executor{4};
+        auto pointSoa = md::toSoa(executor, points, &Point::y);
+        REQUIRE(pointSoa.size() == static_cast<size_t>(n));
+        size_t mismatches = 0;
+        for (int i = 0; i < n; ++i) if (pointSoa.column<0>()[i] != -i) ++mismatches;
+        CHECK(mismatches == 0);
+        CHECK(pointSoa.lengths.size() == 2);
+        auto ys = md::makeReshapedView<3>(pointSoa.column<0>().data(), pointSoa.lengths);
+        CHECK(md::makeFlatView(ys).size() == static_cast<size_t>(n));
+        CHECK(ys[299][2][3] == points[299][2][3].y);
+
+        // Back into a container of the same shape
+        const vector<Point> blank(static_cast<size_t>(n), Point{0, 0});
+        auto rebuilt = md::buildNested<vector<vector<vector<Point>>>>(blank.begin(), blank.end(), pointSoa.lengths);
+        md::fromSoa(executor, pointSoa, rebuilt, &Point::y);
+        auto rebuiltView = md::makeFlatView(rebuilt);
+        auto pointView = md::makeFlatView(points);
+        CHECK(std::equal(rebuiltView.begin(), rebuiltView.end(), pointView.begin(),
+            [](const Point& a, const Point& b) {return a.y == b.y && a.x == 0;}));
+    }
+    SECTION("Conversion") {
+        vector<vector<double>> doubles = {{0.1, 1.0 / 3, 2.5}, {}, {}, {1e300, -0.7}};
+        for (int i = 0; i < 37; ++i) doubles[2].push_back(i * 0.37 - 5);
+        auto fv = md::makeFlatView(doubles);
+
+        vector<float> floats(fv.size());
+        CHECK(md::convert(fv, floats.begin()) == floats.end());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < fv.size(); ++i) if (floats[i] != static_cast<float>(fv[i])) ++mismatches;
+        CHECK(mismatches == 0);
+
+        auto converted = md::makeConvertedView<float>(fv);
+        CHECK(converted.size() == fv.size());
+        CHECK(std::equal(converted.begin(), converted.end(), floats.begin()));
+
+        // Non contiguous segments and output-only iterators
+        vector<list<double>> listed = {{1.5, 2.5}, {-3.25}};
+        list<float> floatList;
+        md::convert<float>(md::makeFlatView(listed), std::back_inserter(floatList));
+        CHECK(floatList == (list<float>{1.5f, 2.5f, -3.25f}));
+
+        // Widening
+        vector<double> widened(floats.size());
+        md::convert(md::makeFlatView(floats), widened.begin());
+        CHECK(std::equal(widened.begin(), widened.end(), floats.begin()));
+
+        // Quantization: q = round(x / 0.5 + 10), halfway cases to even
+        const md::Quantization quantization{0.5, 10};
+        vector<vector<float>> reals = {
+            {1.0f, 100.0f, -100.0f, 0.25f, 0.75f, std::numeric_limits<float>::quiet_NaN()}, {}
+        };
+        for (int i = 0; i < 50; ++i) reals[1].push_back(i * 1.3f - 40);
+        auto rv = md::makeFlatView(reals);
+        vector<int8_t> bytes(rv.size());
+        md::convert(rv, bytes.begin(), quantization);
+        CHECK((vector<int>(bytes.begin(), bytes.begin() + 6)) == (vector<int>{12, 127, -128, 10, 12, -128}));
+        const md::QuantizeScalar<int8_t> quantize{quantization};
+        mismatches = 0;
+        for (size_t i = 0; i < rv.size(); ++i) if (bytes[i] != quantize(rv[i])) ++mismatches;
+        CHECK(mismatches == 0);
+
+        vector<uint8_t> unsignedBytes(rv.size());
+        md::convert(rv, unsignedBytes.begin(), quantization);
+        const md::QuantizeScalar<uint8_t> quantizeUnsigned{quantization};
+        mismatches = 0;
+        for (size_t i = 0; i < rv.size(); ++i) if (unsignedBytes[i] != quantizeUnsigned(rv[i])) ++mismatches;
+        CHECK(mismatches == 0);
+        CHECK(unsignedBytes[2] == 0);
+
+        auto quantized = md::makeConvertedView<int8_t>(rv, quantization);
+        CHECK(std::equal(quantized.begin(), quantized.end(), bytes.begin()));
+        CHECK_THROWS(md::makeConvertedView<int8_t>(rv, md::Quantization{0}));
+    }
 }
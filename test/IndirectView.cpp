@@ -0,0 +1,84 @@
+﻿// This ﬁle is encoded in UTF-8.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iterator>  // std::begin
+
+#include "catch.hpp"
+
+#include "../multidim.hpp"
+
+namespace md = multidim;
+using std::vector;
+using std::string;
+using std::begin;
+using std::end;
+
+// **************************************************************************
+// Helper functions
+template <typename Indices>
+auto canMakeIndirectView(int)
+    -> decltype(md::makeIndirectView(std::declval<vector<vector<int>>&>(), std::declval<Indices>()), true)
+{
+    return true;
+}
+template <typename Indices>
+bool canMakeIndirectView(long) {return false;}
+
+// **************************************************************************
+
+TEST_CASE( "IndirectView", "[multidim]" ) {
+    SECTION("Reordering and subsetting") {
+        const vector<vector<int>> uriahFuller = {{},{1,2,3,},{4},{},{},{5,6}};
+        const vector<size_t> byLength = {1, 5, 2, 0};
+
+        auto iv = md::makeIndirectView(uriahFuller, byLength);
+        CHECK(iv.size() == 4);
+        CHECK(iv[0] == (vector<int> {1,2,3}));
+        CHECK(iv.back() == (vector<int> {}));
+        CHECK(begin(iv).baseIndex() == 1);
+
+        CHECK(md::dimensionality(iv) == 2);
+        CHECK(md::bounds(iv) == (vector<size_t> {4, 3}));
+        CHECK(md::scalarSize(iv) == 6);
+
+        auto fv = md::makeIndirectFlatView(uriahFuller, byLength);
+        CHECK((vector<int>(fv.begin(), fv.end())) == (vector<int> {1,2,3,5,6,4}));
+        CHECK((vector<int>(fv.rbegin(), fv.rend())) == (vector<int> {4,6,5,3,2,1}));
+        CHECK(fv[4] == 6);
+
+        auto bv = md::makeIndirectBoxedView(uriahFuller, byLength, 0, {});
+        CHECK(std::distance(begin(bv), end(bv)) == 4);
+        CHECK(bv[1][1] == 6);
+        CHECK(bv[1][2] == 0);
+        CHECK(bv[3][0] == 0);
+
+        auto bv2 = md::makeIndirectBoxedView(uriahFuller, byLength, 0, vector<size_t> {2, 2});
+        CHECK(bv2[1][0] == 5);
+        CHECK_THROWS(bv2[2]);
+    }
+    SECTION("Repetitions and mutation") {
+        vector<vector<int>> rows = {{1},{2,3}};
+        const vector<size_t> twice = {1, 1, 0};
+
+        auto fv = md::makeIndirectFlatView(rows, twice);
+        CHECK(fv.size() == 5);
+        fv[0] = 20;
+        CHECK(rows[1][0] == 20);
+        CHECK(fv[2] == 20);
+    }
+    SECTION("Invalid indices") {
+        vector<vector<int>> rows = {{1},{2,3}};
+        const vector<size_t> outOfBounds = {0, 2};
+        const vector<size_t> none;
+        CHECK_THROWS(md::makeIndirectView(rows, outOfBounds));
+        CHECK(md::makeIndirectView(rows, none).empty());
+    }
+    SECTION("Temporary indices") {
+        // The View would point to the destroyed indices
+        CHECK(canMakeIndirectView<const vector<size_t>&>(0));
+        CHECK_FALSE(canMakeIndirectView<vector<size_t>>(0));
+        CHECK_FALSE(canMakeIndirectView<vector<size_t>&&>(0));
+    }
+}
@@ -0,0 +1,86 @@
+﻿// This ﬁle is encoded in UTF-8.
+
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <array>
+#include <string>
+
+#include "catch.hpp"
+
+#include "../multidim.hpp"
+
+namespace md = multidim;
+using std::vector;
+using std::map;
+using std::unordered_map;
+using std::string;
+
+// **************************************************************************
+
+TEST_CASE( "KeyedView", "[multidim]" ) {
+    SECTION("Lookup") {
+        map<int, map<int, double>> sparse = {{1, {{2, 1.5}, {7, 2.5}}}, {4, {{0, 3.5}}}};
+
+        auto kv = md::makeKeyedView(sparse, -1.0);
+        CHECK(kv.dimensionality == 2);
+        CHECK(kv[1][2] == 1.5);
+        CHECK(kv[4][0] == 3.5);
+        CHECK(kv[1][3] == -1.0);     // missing inner key
+        CHECK(kv[2][2] == -1.0);     // missing outer key
+        CHECK(kv[2].empty());
+        CHECK(kv.size() == 2);
+        CHECK(kv[1].size() == 2);
+        CHECK(kv.contains(4));
+        CHECK_FALSE(kv[4].contains(1));
+        CHECK(sparse.size() == 2);   // lookups never insert
+
+        CHECK(md::bounds(kv) == (vector<size_t>{5, 8}));
+        CHECK(md::bounds(kv[4]) == (vector<size_t>{1}));
+
+        // Copies share the default value
+        auto copy = md::makeKeyedView(sparse, 9.0);
+        copy = md::makeKeyedView(sparse, 8.0);
+        CHECK(copy[3][0] == 8.0);
+
+        vector<std::array<int, 2>> keys;
+        vector<double> values;
+        kv.forEach([&](const std::array<int, 2>& key, double value) {
+            keys.push_back(key);
+            values.push_back(value);
+        });
+        CHECK(keys == (vector<std::array<int, 2>>{{{1, 2}}, {{1, 7}}, {{4, 0}}}));
+        CHECK(values == (vector<double>{1.5, 2.5, 3.5}));
+    }
+    SECTION("Hashed and mixed levels") {
+        unordered_map<size_t, map<size_t, unordered_map<size_t, string>>> sparse;
+        sparse[10][3][7] = "a";
+        sparse[10][5][0] = "b";
+        sparse[2][0][1] = "c";
+
+        auto kv = md::makeKeyedView(sparse, string{"-"});
+        CHECK(kv.dimensionality == 3);
+        CHECK(kv[10][3][7] == "a");
+        CHECK(kv[10][3][8] == "-");
+        CHECK(kv[11][3][7] == "-");
+        CHECK(md::bounds(kv) == (vector<size_t>{11, 6, 8}));
+
+        size_t count = 0;
+        kv.forEach([&](const std::array<size_t, 3>& key, const string& value) {
+            CHECK(sparse[key[0]][key[1]][key[2]] == value);
+            ++count;
+        });
+        CHECK(count == 3);
+
+        map<int, int> negative = {{-1, 5}};
+        CHECK(md::makeKeyedView(negative)[-1] == 5);
+        CHECK_THROWS(md::bounds(md::makeKeyedView(negative)));
+
+        // forEach passes all the keys in one array: it requires one key type
+        map<string, map<int, double>> named = {{"x", {{65, 1.0}}}};
+        CHECK(md::makeKeyedView(named)["x"][65] == 1.0);
+        CHECK(md::KeyedSameKeys<decltype(sparse)>::value == true);
+        CHECK(md::KeyedSameKeys<decltype(named)>::value == false);
+    }
+}
@@ -0,0 +1,138 @@
+﻿// This ﬁle is encoded in UTF-8.
+
+#include <iostream>
+#include <vector>
+#include <list>
+#include <array>
+#include <string>
+#include <iterator>  // std::begin
+
+#include "catch.hpp"
+
+#include "../multidim.hpp"
+
+namespace md = multidim;
+using std::vector;
+using std::begin;
+using std::end;
+
+// **************************************************************************
+
+TEST_CASE( "ReshapedView", "[multidim]" ) {
+    SECTION("Jagged") {
+        vector<int> buffer = {1,2,3,4,5,6};
+        const vector<size_t> rowLengths = {2, 0, 3, 1};
+
+        auto rv = md::makeReshapedView(buffer.data(), rowLengths);
+        CHECK(rv.size() == 4);
+        CHECK(rv[1].empty());
+        CHECK(rv[2][2] == 5);
+        CHECK((vector<int>(begin(rv[3]), end(rv[3]))) == (vector<int> {6}));
+
+        CHECK(md::dimensionality(rv) == 2);
+        CHECK(md::bounds(rv) == (vector<size_t> {4, 3}));
+        CHECK(md::scalarSize(rv) == 6);
+
+        auto fv = md::makeFlatView(rv);
+        CHECK((vector<int>(fv.begin(), fv.end())) == buffer);
+        CHECK((vector<int>(fv.rbegin(), fv.rend())) == (vector<int> {6,5,4,3,2,1}));
+
+        auto bv = md::makeBoxedView(rv, -1, {});
+        CHECK(bv[0][2] == -1);
+        CHECK(bv[2][1] == 4);
+        CHECK(bv[1][0] == -1);
+
+        // The View refers to the buffer
+        rv[0][1] = 20;
+        CHECK(buffer[1] == 20);
+        fv[5] = 60;
+        CHECK(buffer[5] == 60);
+
+        // Three levels: 2 rows, holding 1 and 2 subrows
+        const int constBuffer[] = {1,2,3,4,5};
+        auto rv3 = md::makeReshapedView(constBuffer, {1, 2}, vector<size_t> {2, 0, 3});
+        CHECK(md::dimensionality(rv3) == 3);
+        CHECK(md::bounds(rv3) == (vector<size_t> {2, 2, 3}));
+        CHECK(rv3[1][1][2] == 5);
+        CHECK(rv3[1][0].empty());
+
+        CHECK_THROWS(md::makeReshapedView(constBuffer, {1, 2}, vector<size_t> {2, 3}));
+    }
+    SECTION("Boxed") {
+        vector<int> buffer(24);
+        for (size_t i = 0; i < buffer.size(); ++i) buffer[i] = static_cast<int>(i);
+
+        auto rv = md::makeReshapedView(buffer.data(), std::array<size_t, 3> {{2, 3, 4}});
+        CHECK(md::dimensionality(rv) == 3);
+        CHECK(md::bounds(rv) == (vector<size_t> {2, 3, 4}));
+        CHECK(rv[1][2][3] == 23);
+        CHECK(rv[1][0][0] == 12);
+
+        auto fv = md::makeFlatView(rv);
+        CHECK(std::equal(fv.begin(), fv.end(), buffer.begin()));
+        auto parts = fv.split(3);
+        CHECK(*parts[1].begin() == 8);
+
+        auto bv = md::makeBoxedView(rv, 0, {2, 2, 5});
+        CHECK(bv[1][1][3] == 19);
+        CHECK(bv[1][1][4] == 0);
+
+        // A braced list is always a jagged shape
+        auto jagged = md::makeReshapedView(buffer.data(), {2, 0, 3});
+        CHECK(md::dimensionality(jagged) == 2);
+        CHECK(jagged.size() == 3);
+        CHECK(jagged[1].empty());
+        CHECK(jagged[2][2] == 4);
+
+        // Large boxed Views need no offsets
+        auto wide = md::makeReshapedView(buffer.data(), std::array<size_t, 3> {{size_t{1} << 40, 1, 0}});
+        CHECK(wide.size() == (size_t{1} << 40));
+        CHECK(wide[12345].size() == 1);
+        CHECK(wide[12345][0].empty());
+
+        auto rv1 = md::makeReshapedView(buffer.data(), std::array<size_t, 1> {5});
+        CHECK(md::dimensionality(rv1) == 1);
+        CHECK(rv1.size() == 5);
+        CHECK(rv1[4] == 4);
+    }
+    SECTION("buildNested") {
+        const vector<int> flat = {1,2,3,4,5,6};
+
+        auto jagged = md::buildNested<vector<vector<int>>>(flat.begin(), flat.end(), {{2, 0, 3, 1}});
+        CHECK(jagged == (vector<vector<int>> {{1,2}, {}, {3,4,5}, {6}}));
+        CHECK(jagged[2].capacity() == 3);
+
+        auto boxed = md::buildNested<vector<vector<int>>>(flat.begin(), flat.end(), std::array<size_t, 2> {{3, 2}});
+        CHECK(boxed == (vector<vector<int>> {{1,2}, {3,4}, {5,6}}));
+
+        // Round trip through a FlatView, on a pool
+        md::ThreadPoolExecutor pool{3};
+        vector<int> big(5000);
+        for (size_t i = 0; i < big.size(); ++i) big[i] = static_cast<int>(i);
+        vector<size_t> rowLengths(1000, 2);
+        vector<size_t> subrowLengths(2000);
+        for (size_t i = 0; i < subrowLengths.size(); ++i) subrowLengths[i] = (i % 2 == 0) ? 1 : 4;
+        auto deep = md::buildNested<vector<vector<vector<int>>>>(
+            big.begin(), big.end(), {rowLengths, subrowLengths}, pool
+        );
+        CHECK(deep.size() == 1000);
+        CHECK(deep[999][1] == (vector<int> {4996,4997,4998,4999}));
+        auto fv = md::makeFlatView(deep);
+        CHECK(std::equal(fv.begin(), fv.end(), big.begin()));
+
+        using Table = vector<vector<std::string>>;
+        const vector<std::string> words = {"A", "B", "C"};
+        auto table = md::buildNested<Table, md::StringsAsScalars>(words.begin(), words.end(), std::array<size_t, 2> {{1, 3}});
+        CHECK(table == (Table {{"A", "B", "C"}}));
+
+        // From a range without random access, on a pool
+        const std::list<int> bigList(big.begin(), big.end());
+        auto fromList = md::buildNested<vector<vector<vector<int>>>>(
+            bigList.begin(), bigList.end(), {rowLengths, subrowLengths}, pool
+        );
+        CHECK(fromList == deep);
+
+        CHECK_THROWS(md::buildNested<vector<vector<int>>>(flat.begin(), flat.end(), {{2, 2}}));
+        CHECK_THROWS(md::buildNested<vector<vector<int>>>(flat.begin(), flat.end(), std::array<size_t, 3> {{2, 2, 2}}));
+    }
+}
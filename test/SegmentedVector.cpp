@@ -0,0 +1,127 @@
+﻿// This ﬁle is encoded in UTF-8.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+#include "catch.hpp"
+
+#include "../multidim.hpp"
+
+namespace md = multidim;
+using std::vector;
+using std::string;
+
+// **************************************************************************
+// Helper class: counts its instances, and its copies can be made to throw
+struct Fragile {
+    static int live;
+    static int copiesBeforeThrow;
+
+    explicit Fragile(int v) : value{v} {++live;}
+    Fragile(const Fragile& other) : value{other.value} {
+        if (copiesBeforeThrow-- == 0) throw std::runtime_error("Fragile : copy failed");
+        ++live;
+    }
+    ~Fragile() {--live;}
+
+    int value;
+};
+int Fragile::live = 0;
+int Fragile::copiesBeforeThrow = -1;
+
+// **************************************************************************
+
+TEST_CASE( "SegmentedVector", "[multidim]" ) {
+    SECTION("Appends") {
+        md::SegmentedVector<int, 4> segmented = {1, 2, 3};
+        const int* address = &segmented[0];
+        auto fv = md::makeFlatView(segmented);
+        auto first = segmented.begin();
+
+        for (int i = 4; i <= 10; ++i) segmented.push_back(i);
+        CHECK(&segmented[0] == address);    // no relocation
+        CHECK(segmented.size() == 10);
+        CHECK(segmented.capacity() == 12);
+        CHECK(segmented.back() == 10);
+        CHECK_THROWS(segmented.at(10));
+
+        // Views and iterators taken before the appends are still valid
+        CHECK((vector<int>(fv.begin(), fv.end())) == (vector<int>{1, 2, 3}));
+        CHECK(*first == 1);
+
+        auto chunks = segmented.chunks();
+        REQUIRE(chunks.size() == 3);
+        CHECK(chunks[2].size() == 2);
+        CHECK(chunks[1][0] == 5);
+
+        auto all = md::makeFlatView(segmented);
+        CHECK((vector<int>(all.begin(), all.end())) == (vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+        CHECK((vector<int>(all.rbegin(), all.rend())) == (vector<int>{10, 9, 8, 7, 6, 5, 4, 3, 2, 1}));
+        CHECK(all.size() == 10);
+        CHECK(all[5] == 6);
+        size_t segments = 0;
+        md::forEachSegment(all, [&](int*, size_t count) {
+            CHECK(count <= 4);
+            ++segments;
+        });
+        CHECK(segments == 3);
+
+        CHECK((vector<int>(segmented.begin(), segmented.end())) == (vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+        CHECK(segmented.end() - segmented.begin() == 10);
+        CHECK(md::scalarSize(segmented) == 10);
+        CHECK(md::bounds(segmented) == (vector<size_t>{10}));
+
+        const auto& constSegmented = segmented;
+        auto constView = md::makeFlatView(constSegmented);
+        CHECK(std::accumulate(constView.begin(), constView.end(), 0) == 55);
+    }
+    SECTION("Elements") {
+        md::SegmentedVector<string, 2> strings;
+        strings.emplace_back(3, 'a');
+        strings.push_back("b");
+        strings.push_back(strings[0]);
+        auto copy = strings;
+        strings.pop_back();
+        CHECK(strings.size() == 2);
+        CHECK(copy.size() == 3);
+        CHECK(copy[2] == "aaa");
+        CHECK(copy != strings);
+        strings = std::move(copy);
+        CHECK(strings.size() == 3);
+        strings.clear();
+        CHECK(strings.empty());
+
+        vector<md::SegmentedVector<int, 2>> jagged(3);
+        jagged[0] = {1, 2, 3};
+        jagged[2] = {4};
+        auto fv = md::makeFlatView(jagged);
+        CHECK((vector<int>(fv.begin(), fv.end())) == (vector<int>{1, 2, 3, 4}));
+        CHECK(md::bounds(jagged) == (vector<size_t>{3, 3}));
+
+        // Rows are moved, not copied, when the outer vector grows
+        static_assert(std::is_nothrow_move_constructible<md::SegmentedVector<string>>::value, "");
+        vector<md::SegmentedVector<string, 2>> rows(1);
+        rows[0] = {"a", "b", "c"};
+        const string* element = &rows[0][2];
+        for (int i = 0; i < 10; ++i) rows.emplace_back();
+        CHECK(&rows[0][2] == element);
+    }
+    SECTION("Throwing copies") {
+        {
+            md::SegmentedVector<Fragile, 2> source;
+            for (int i = 0; i < 5; ++i) source.emplace_back(i);
+            Fragile::copiesBeforeThrow = 3;
+            CHECK_THROWS((md::SegmentedVector<Fragile, 2>{source}));
+            CHECK(Fragile::live == 5);     // the partial copy was destroyed
+            Fragile::copiesBeforeThrow = 1;
+            CHECK_THROWS((md::SegmentedVector<Fragile, 2>{Fragile{1}, Fragile{2}, Fragile{3}}));
+            CHECK(Fragile::live == 5);
+            Fragile::copiesBeforeThrow = -1;
+        }
+        CHECK(Fragile::live == 0);
+    }
+}
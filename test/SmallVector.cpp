@@ -0,0 +1,108 @@
+﻿// This ﬁle is encoded in UTF-8.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+
+#include "catch.hpp"
+
+#include "../multidim.hpp"
+
+namespace md = multidim;
+using std::vector;
+using std::string;
+
+// **************************************************************************
+
+TEST_CASE( "SmallVector", "[multidim]" ) {
+    SECTION("Storage") {
+        md::SmallVector<string, 2> row;
+        CHECK(row.isInline());
+        row.push_back("a");
+        row.emplace_back("b");
+        CHECK(row.isInline());
+        row.push_back(row[0]);   // an element of the full vector itself
+        CHECK_FALSE(row.isInline());
+        CHECK((vector<string>(row.begin(), row.end())) == (vector<string>{"a", "b", "a"}));
+
+        row.pop_back();
+        row.shrink_to_fit();
+        CHECK(row.isInline());
+        CHECK(row.size() == 2);
+        CHECK(row.back() == "b");
+        CHECK_THROWS(row.at(2));
+
+        md::SmallVector<string, 2> copy{row};
+        md::SmallVector<string, 2> big(5, "x");
+        md::SmallVector<string, 2> moved{std::move(big)};
+        CHECK(big.empty());
+        CHECK(moved.size() == 5);
+        swap(copy, moved);
+        CHECK(copy.size() == 5);
+        CHECK(moved == row);
+        copy = {"y"};
+        CHECK(copy.size() == 1);
+        CHECK(row < copy);
+
+        // no leaks nor double destructions
+        auto counted = std::make_shared<int>(0);
+        {
+            md::SmallVector<std::shared_ptr<int>, 3> pointers(7, counted);
+            pointers.resize(2);
+            auto other = pointers;
+            other.resize(9, counted);
+            pointers = std::move(other);
+            CHECK(counted.use_count() == 10);
+        }
+        CHECK(counted.use_count() == 1);
+    }
+    SECTION("Filling with one of the elements") {
+        const std::string word = "a string too long to be stored inline";
+        md::SmallVector<std::string, 2> strings{word};
+        strings.resize(10, strings[0]);     // reallocates
+        CHECK(strings.size() == 10);
+        CHECK(strings[9] == word);
+        strings.resize(12, strings[3]);
+        CHECK(strings[11] == word);
+
+        md::SmallVector<std::string, 2> others{"x", word};
+        others.assign(20, others[1]);
+        CHECK(others.size() == 20);
+        CHECK(others[0] == word);
+        CHECK(others[19] == word);
+    }
+    SECTION("Jagged container") {
+        md::SmallJagged<int> rows = {{1, 2}, {}, {3, 4, 5, 6, 7, 8}, {9}};
+        CHECK(rows[0].isInline());
+        CHECK_FALSE(rows[2].isInline());
+
+        CHECK(md::dimensionality(rows) == 2);
+        CHECK(md::bounds(rows) == (vector<size_t>{4, 6}));
+        CHECK(md::scalarSize(rows) == 9);
+
+        auto fv = md::makeFlatView(rows);
+        CHECK((vector<int>(fv.begin(), fv.end())) == (vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9}));
+        CHECK((vector<int>(fv.rbegin(), fv.rend())) == (vector<int>{9, 8, 7, 6, 5, 4, 3, 2, 1}));
+        auto filtered = md::makeFilteredFlatView(fv, [](int i) {return i % 2 == 0;});
+        CHECK((vector<int>(filtered.begin(), filtered.end())) == (vector<int>{2, 4, 6, 8}));
+
+        auto bv = md::makeBoxedView(rows, 0, {});
+        CHECK(bv[2][5] == 8);
+        CHECK(bv[3][1] == 0);
+
+        // Growing the outer vector moves the rows, inline or not
+        for (int i = 0; i < 100; ++i) rows.push_back({i});
+        CHECK(rows[2].size() == 6);
+        CHECK(rows[103][0] == 99);
+
+        const vector<int> flat = {1, 2, 3, 4, 5};
+        auto built = md::buildNested<md::SmallJagged<int>>(flat.begin(), flat.end(), {{2, 0, 3}});
+        CHECK(built[2] == (md::SmallVector<int>{3, 4, 5}));
+
+        vector<int> output;
+        md::extract(built, output, true);
+        CHECK(output == flat);
+        CHECK(built[2].empty());
+    }
+}
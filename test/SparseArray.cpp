@@ -0,0 +1,126 @@
+﻿// This ﬁle is encoded in UTF-8.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <array>
+#include <map>
+#include <random>
+#include <iterator>  // std::begin
+
+#include "catch.hpp"
+
+#include "../multidim.hpp"
+
+namespace md = multidim;
+using std::vector;
+using std::begin;
+using std::end;
+
+// **************************************************************************
+
+TEST_CASE( "SparseArray", "[multidim]" ) {
+    SECTION("Access") {
+        using Index = std::array<size_t, 3>;
+        auto sparse = md::makeSparseArray(Index{{10000, 10000, 10000}}, 0.0);   // 1e12 cells
+        CHECK(sparse.logicalSize() == 1000000000000ull);
+        CHECK(sparse.storedSize() == 0);
+
+        sparse[1][2][3] = 1.5;
+        sparse.set(Index{{9999, 9999, 9999}}, 2.5);
+        CHECK(sparse[1][2][3] == 1.5);
+        CHECK(sparse.get(Index{{1, 2, 3}}) == 1.5);
+        CHECK(sparse[9999][9999][9999] == 2.5);
+        CHECK(sparse[1][2][4] == 0.0);
+        CHECK(sparse.storedSize() == 2);
+        CHECK(sparse.contains(Index{{1, 2, 3}}));
+        CHECK_FALSE(sparse.contains(Index{{1, 2, 4}}));
+        CHECK_THROWS(sparse.get(Index{{1, 2, 10000}}));
+
+        sparse[1][2][3] = 0.0;  // storing the default value erases the cell
+        CHECK(sparse.storedSize() == 1);
+        CHECK_FALSE(sparse.contains(Index{{1, 2, 3}}));
+
+        CHECK(md::bounds(sparse) == (vector<size_t>{10000, 10000, 10000}));
+        CHECK(md::scalarSize(sparse) == 1000000000000ull);
+        CHECK(md::scalarSize(sparse, md::SparseCells::stored) == 1);
+        CHECK(sparse.size() == 10000);
+        CHECK(sparse[5].size() == 10000);
+
+        const auto& constSparse = sparse;
+        CHECK(constSparse[9999][9999][9999] == 2.5);
+
+        using Huge = std::array<size_t, 2>;
+        CHECK_THROWS(md::makeSparseArray(Huge{{size_t{1} << 40, size_t{1} << 40}}, 0));
+    }
+    SECTION("Hash table") {
+        using Index = std::array<size_t, 2>;
+        md::SparseArray<int, 2> sparse{Index{{300, 300}}, -1};
+        std::map<std::pair<size_t, size_t>, int> reference;
+        std::mt19937 random{42};
+        for (int step = 0; step < 20000; ++step) {
+            const Index index{{random() % 300, random() % 300}};
+            const int value = static_cast<int>(random() % 4) - 1;    // -1 erases
+            sparse.set(index, value);
+            if (value == -1) {
+                reference.erase({index[0], index[1]});
+            } else {
+                reference[{index[0], index[1]}] = value;
+            }
+        }
+        CHECK(sparse.storedSize() == reference.size());
+        size_t mismatches = 0;
+        sparse.forEachStored([&](const Index& index, int value) {
+            if (reference.at({index[0], index[1]}) != value) ++mismatches;
+        });
+        for (const auto& entry : reference) {
+            if (sparse.get(Index{{entry.first.first, entry.first.second}}) != entry.second) ++mismatches;
+        }
+        CHECK(mismatches == 0);
+
+        auto coo = sparse.toCoo();
+        REQUIRE(coo.size() == reference.size());
+        auto entry = reference.begin();
+        for (size_t n = 0; n < coo.size(); ++n, ++entry) {
+            if (coo.indices[0][n] != entry->first.first || coo.indices[1][n] != entry->first.second) ++mismatches;
+            if (coo.values[n] != entry->second) ++mismatches;
+        }
+        CHECK(mismatches == 0);
+
+        sparse.clear();
+        CHECK(sparse.storedSize() == 0);
+        CHECK(sparse[0][0] == -1);
+    }
+    SECTION("Views") {
+        using Index = std::array<size_t, 2>;
+        md::SparseArray<int, 2> sparse{Index{{3, 4}}};
+        sparse[0][1] = 1;
+        sparse[2][3] = 2;
+
+        CHECK(md::dimensionality(sparse) == 2);
+        auto fv = md::makeFlatView(sparse);
+        CHECK((vector<int>(fv.begin(), fv.end())) == (vector<int>{0,1,0,0, 0,0,0,0, 0,0,0,2}));
+
+        auto bv = md::makeBoxedView(sparse, -1, {4, 2});
+        CHECK(bv[0][1] == 1);
+        CHECK(bv[3][0] == -1);
+
+        for (auto&& cell : sparse[1]) cell = 5;
+        CHECK(sparse.storedSize() == 6);
+    }
+    SECTION("Assigning a cell to another one across a rehash") {
+        using Index = std::array<size_t, 2>;
+        md::SparseArray<std::string, 2> sparse{Index{{4, 4}}};
+        for (size_t i = 0; i < 12; ++i) {
+            sparse.set(Index{{i / 4, i % 4}}, "a long string, not stored inline " + std::to_string(i));
+        }
+        REQUIRE(sparse.storedSize() == 12);
+
+        sparse[3][0] = sparse[0][3];   // the 13th cell grows the table
+        CHECK(sparse.storedSize() == 13);
+        CHECK(sparse.get(Index{{3, 0}}) == "a long string, not stored inline 3");
+        sparse.set(Index{{3, 1}}, sparse.get(Index{{1, 2}}));
+        CHECK(sparse.get(Index{{3, 1}}) == "a long string, not stored inline 6");
+        CHECK(sparse.get(Index{{0, 3}}) == "a long string, not stored inline 3");
+    }
+}
@@ -0,0 +1,87 @@
+﻿// This ﬁle is encoded in UTF-8.
+
+#include <iostream>
+#include <list>
+#include <vector>
+#include <string>
+#include <tuple>
+#include <iterator>  // std::begin
+
+#include "catch.hpp"
+
+#include "../multidim.hpp"
+
+namespace md = multidim;
+using std::vector;
+using std::list;
+using std::string;
+using std::begin;
+using std::end;
+
+// **************************************************************************
+
+TEST_CASE( "ZipView", "[multidim]" ) {
+    SECTION("Iteration") {
+        const vector<vector<int>> values = {{},{1,2,3,},{4},{},{},{5,6}};
+        const list<vector<float>> weights = {{},{.5,.25,.125},{2},{},{},{1,3}};
+
+        auto zv = md::zip(md::makeFlatView(values), md::makeFlatView(weights));
+        CHECK(zv.size() == 6);
+        CHECK(zv.empty() == false);
+
+        float weightedSum = 0;
+        for (auto pair : zv) weightedSum += std::get<0>(pair) * std::get<1>(pair);
+        CHECK(weightedSum == (0.5f + 0.5f + 0.375f + 8 + 5 + 18));
+
+        auto it = zv.begin();
+        CHECK(std::get<0>(*it) == 1);
+        CHECK(std::get<1>(*it) == 0.5);
+        it++;
+        ++it;
+        CHECK(std::get<0>(*it) == 3);
+        CHECK(std::distance(it, zv.end()) == 4);
+        CHECK_THROWS(*zv.end());
+    }
+    SECTION("Three views and mutation") {
+        vector<vector<int>> values = {{1,2},{},{3}};
+        const vector<vector<int>> weights = {{10,20},{},{30}};
+        vector<vector<bool>> masks = {{true,false},{},{true}};
+
+        auto zv = md::zip(md::makeFlatView(values), md::makeFlatView(weights), md::makeFlatView(masks));
+        for (auto triple : zv) {
+            if (std::get<2>(triple)) std::get<0>(triple) *= std::get<1>(triple);
+            std::get<2>(triple) = false;
+        }
+        CHECK(values == (vector<vector<int>>{{10,2},{},{90}}));
+        CHECK(masks == (vector<vector<bool>>{{false,false},{},{false}}));
+    }
+    SECTION("Empty and mismatching shapes") {
+        vector<vector<int>> empty1 = {{},{}};
+        vector<vector<int>> empty2 = {{},{}};
+        auto zv = md::zip(md::makeFlatView(empty1), md::makeFlatView(empty2));
+        CHECK(zv.empty() == true);
+        CHECK(zv.begin() == zv.end());
+
+        vector<vector<int>> a = {{1,2},{3}};
+        vector<vector<int>> b = {{1},{2,3}};   // same scalarSize, different shape
+        vector<vector<int>> c = {{1,2},{3},{}};  // one row more
+        CHECK_THROWS(md::zip(md::makeFlatView(a), md::makeFlatView(b)));
+        CHECK_THROWS(md::zip(md::makeFlatView(a), md::makeFlatView(c)));
+        CHECK_NOTHROW(md::zip(md::makeFlatView(a), md::makeFlatView(a)));
+    }
+    SECTION("Split parts") {
+        vector<vector<int>> a = {{1,2},{3,4},{5,6}};
+        vector<vector<int>> b = {{1,2},{3,4},{5,6}};
+        auto fa = md::makeFlatView(a);
+        auto fb = md::makeFlatView(b);
+        auto partsA = fa.split(3);
+        auto partsB = fb.split(2);
+        CHECK(partsA[0].isPart() == true);
+        CHECK(fa.isPart() == false);
+        // parts would silently expose the whole ranges
+        CHECK_THROWS(md::zip(partsA[0], partsB[0]));
+        CHECK_THROWS(md::zip(partsA[0], partsB[1]));
+        CHECK_THROWS(md::zip(fa, partsB[1]));
+        CHECK(md::zip(fa, fb).size() == 6);
+    }
+}